@@ -0,0 +1,54 @@
+// Minimal microbenchmark helpers for the host build - no external framework needed
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace bench {
+
+/* --quick runs every benchmark only briefly, ctest uses it to keep the benchmarks building and running */
+inline double min_seconds(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        {
+            return 0.01;
+        }
+    }
+    return 0.5;
+}
+
+/* Keeps the compiler from optimizing away values computed by the benchmarked code */
+template<typename T> inline void keep(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/* Calls fn in growing batches until at least min_seconds passed, returns seconds per call */
+template<typename F> double time_per_call(F &&fn, double min_seconds)
+{
+    using clock = std::chrono::steady_clock;
+
+    size_t calls = 0;
+    double elapsed = 0;
+    auto start = clock::now();
+    for (size_t batch = 1; elapsed < min_seconds; batch *= 2)
+    {
+        for (size_t i = 0; i < batch; i++)
+        {
+            fn();
+        }
+        calls += batch;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    }
+    return elapsed / calls;
+}
+
+inline void report(const char *name, double value, const char *unit)
+{
+    printf("%-48s %14.2f %s\n", name, value, unit);
+}
+
+}  // namespace bench
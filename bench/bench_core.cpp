@@ -0,0 +1,83 @@
+// Microbenchmarks of the protocol core - framing and unit report decoding, SET frame encoding is in bench_encode
+#include <vector>
+
+#include "bench.h"
+#include "esppac_core.h"
+
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+static const size_t STREAM_FRAMES = 1000;
+static const size_t CHUNK_MAX = 64;  /* same as RX_CHUNK_MAX of the component */
+
+static bool header_check(void *ctx, uint8_t len, uint8_t cmd)
+{
+    return is_valid_header(len, cmd);
+}
+
+/* Unit reports as AC sends them, with settings changing from frame to frame */
+static std::vector<uint8_t> report_stream()
+{
+    std::vector<uint8_t> stream;
+    SetFrame report;
+    report.init(protocol::CMD_IN_UNIT_REPORT);
+    for (size_t i = 0; i < STREAM_FRAMES; i++)
+    {
+        ACSettings_t settings = {};
+        settings.fan_mode = i % fan_modes::COUNT;
+        settings.vertical_swing = i % vertical_swing_options::COUNT;
+        settings.horizontal_swing = i % horizontal_swing_options::COUNT;
+        settings.sleep = i & 1;
+        report.encode_mode(i % (protocol::REPORT_MODE_HEAT + 1), true);
+        report.encode_target_temperature(16 + i % 15);
+        report.encode_fan_mode(settings.fan_mode);
+        report.encode_vertical_swing(settings.vertical_swing);
+        report.encode_horizontal_swing(settings.horizontal_swing);
+        report.encode_display(display_options::AUTO, display_options::AUTO);
+        report.encode_flags(settings);
+        report.encode_current_temperature(20.0f + (i % 20) / 2.0f);
+        stream.insert(stream.end(), report.data(), report.data() + report.size());
+    }
+    return stream;
+}
+
+int main(int argc, char **argv)
+{
+    double min_seconds = bench::min_seconds(argc, argv);
+    std::vector<uint8_t> stream = report_stream();
+    size_t frame_len = stream.size() / STREAM_FRAMES;
+
+    /* FRAMING - bytes fed through serial_parse() in UART sized chunks, frames handed over right away */
+    SerialProcess_t process = {};
+    size_t frames = 0;
+    double per_stream = bench::time_per_call([&]() {
+        for (size_t pos = 0; pos < stream.size();)
+        {
+            FrameEvent event;
+            size_t len = std::min(stream.size() - pos, CHUNK_MAX);
+            pos += serial_parse(process, stream.data() + pos, len, header_check, nullptr, event);
+            if (event == FrameEvent::FRAME)
+            {
+                frames++;
+                process.pending = nullptr;
+            }
+        }
+    }, min_seconds);
+    bench::keep(frames);
+    bench::report("framing", stream.size() / per_stream / 1e6, "MB/s");
+    bench::report("framing", STREAM_FRAMES / per_stream / 1e6, "M frames/s");
+
+    /* DECODING - payload of every frame decoded in place */
+    UnitReport_t report;
+    double per_pass = bench::time_per_call([&]() {
+        for (size_t pos = 0; pos < stream.size(); pos += frame_len)
+        {
+            FrameView payload = {stream.data() + pos + 4, (uint8_t) (frame_len - 5)};
+            decode_unit_report(payload, report);
+            bench::keep(report);
+        }
+    }, min_seconds);
+    bench::report("decode_unit_report", STREAM_FRAMES / per_pass / 1e6, "M frames/s");
+
+    return 0;
+}
@@ -0,0 +1,553 @@
+// Old vs new SET frame encoding - the work send_packet() did before SetFrame, building the frame from scratch out of
+// option strings into a std::vector, against SetFrame rebuilt in full and patched for keep-alive. The output of the old
+// encoder itself is checked by test_set_frame against tests/data/set_frames.golden
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "esphome/components/climate/climate_mode.h"
+#include "esppac_core.h"
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+/* The encoder of send_packet() before SetFrame, copied verbatim from the baseline with the state it read and the
+   string option constants of that time. Only the refresh timing check in front and UART write, logging and update
+   state machine after it are left out */
+namespace legacy {
+
+namespace fan_modes{
+    const std::string FAN_AUTO  = "0 - Auto";
+    const std::string FAN_QUIET = "1 - Quiet";
+    const std::string FAN_LOW   = "2 - Low";
+    const std::string FAN_MEDL  = "3 - Medium-Low";
+    const std::string FAN_MED   = "4 - Medium";
+    const std::string FAN_MEDH  = "5 - Medium-High";
+    const std::string FAN_HIGH  = "6 - High";
+    const std::string FAN_TURBO = "7 - Turbo";
+}
+
+namespace horizontal_swing_options{
+    const std::string OFF    = "0 - OFF";
+    const std::string FULL   = "1 - Swing - Full";
+    const std::string CLEFT  = "2 - Constant - Left";
+    const std::string CMIDL  = "3 - Constant - Mid-Left";
+    const std::string CMID   = "4 - Constant - Middle";
+    const std::string CMIDR  = "5 - Constant - Mid-Right";
+    const std::string CRIGHT = "6 - Constant - Right";
+}
+
+namespace vertical_swing_options{
+    const std::string OFF   = "00 - OFF";
+    const std::string FULL  = "01 - Swing - Full";
+    const std::string DOWN  = "02 - Swing - Down";
+    const std::string MIDD  = "03 - Swing - Mid-Down";
+    const std::string MID   = "04 - Swing - Middle";
+    const std::string MIDU  = "05 - Swing - Mid-Up";
+    const std::string UP    = "06 - Swing - Up";
+    const std::string CDOWN = "07 - Constant - Down";
+    const std::string CMIDD = "08 - Constant - Mid-Down";
+    const std::string CMID  = "09 - Constant - Middle";
+    const std::string CMIDU = "10 - Constant - Mid-Up";
+    const std::string CUP   = "11 - Constant - Up";
+}
+
+namespace display_options{
+    const std::string OFF  = "0 - OFF";
+    const std::string AUTO = "1 - Auto";
+    const std::string SET  = "2 - Set temperature";
+    const std::string ACT  = "3 - Actual temperature";
+    const std::string OUT  = "4 - Outside temperature";
+}
+
+namespace display_unit_options{
+    const std::string DEGC = "C";
+    const std::string DEGF = "F";
+}
+
+static const std::string *const FAN_MODES[] = {
+    &fan_modes::FAN_AUTO, &fan_modes::FAN_QUIET, &fan_modes::FAN_LOW, &fan_modes::FAN_MEDL,
+    &fan_modes::FAN_MED, &fan_modes::FAN_MEDH, &fan_modes::FAN_HIGH, &fan_modes::FAN_TURBO,
+};
+static const std::string *const VERTICAL_SWING[] = {
+    &vertical_swing_options::OFF, &vertical_swing_options::FULL, &vertical_swing_options::DOWN,
+    &vertical_swing_options::MIDD, &vertical_swing_options::MID, &vertical_swing_options::MIDU,
+    &vertical_swing_options::UP, &vertical_swing_options::CDOWN, &vertical_swing_options::CMIDD,
+    &vertical_swing_options::CMID, &vertical_swing_options::CMIDU, &vertical_swing_options::CUP,
+};
+static const std::string *const HORIZONTAL_SWING[] = {
+    &horizontal_swing_options::OFF, &horizontal_swing_options::FULL, &horizontal_swing_options::CLEFT,
+    &horizontal_swing_options::CMIDL, &horizontal_swing_options::CMID, &horizontal_swing_options::CMIDR,
+    &horizontal_swing_options::CRIGHT,
+};
+static const std::string *const DISPLAY[] = {
+    &display_options::OFF, &display_options::AUTO, &display_options::SET, &display_options::ACT, &display_options::OUT,
+};
+
+enum class ACUpdate {
+    NoUpdate,    /* no parameters changed - normally process data, static flag set */
+    UpdateStart, /* start update with 0xAF and cleared static flag */
+    UpdateClear, /* update without 0xAF and cleared static flag */
+};
+
+class SinclairACCNT {
+    public:
+        std::vector<uint8_t> send_packet();
+
+        climate::ClimateMode mode;
+        float target_temperature;
+        std::optional<std::string> custom_fan_mode;
+
+        std::string vertical_swing_state_;
+        std::string horizontal_swing_state_;
+        std::string display_state_;
+        std::string display_unit_state_;
+        bool plasma_state_;
+        bool sleep_state_;
+        bool xfan_state_;
+        bool save_state_;
+
+        ACUpdate update_;
+        climate::ClimateMode mode_internal_;
+        std::string display_mode_internal_;
+        bool display_power_internal_;
+};
+
+std::vector<uint8_t> SinclairACCNT::send_packet()
+{
+    std::vector<uint8_t> packet(protocol::SET_PACKET_LEN, 0);  /* Initialize packet contents */
+
+    packet[protocol::SET_CONST_02_BYTE] = protocol::SET_CONST_02_VAL; /* Some always 0x02 byte... */
+    packet[protocol::SET_CONST_BIT_BYTE] = protocol::SET_CONST_BIT_MASK; /* Some always true bit */
+
+    /* Prepare the rest of the frame */
+    /* this handles tricky part of 0xAF value and flag marking that WiFi does not apply any changes */
+    switch(this->update_)
+    {
+        default:
+        case ACUpdate::NoUpdate:
+            packet[protocol::SET_NOCHANGE_BYTE] |= protocol::SET_NOCHANGE_MASK;
+            break;
+        case ACUpdate::UpdateStart:
+            packet[protocol::SET_AF_BYTE] = protocol::SET_AF_VAL;
+            break;
+        case ACUpdate::UpdateClear:
+            break;
+    }
+
+    /* MODE and POWER --------------------------------------------------------------------------- */
+    uint8_t mode = protocol::REPORT_MODE_AUTO;
+    bool power = false;
+    switch (this->mode)
+    {
+        case climate::CLIMATE_MODE_AUTO:
+            mode = protocol::REPORT_MODE_AUTO;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_COOL:
+            mode = protocol::REPORT_MODE_COOL;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_DRY:
+            mode = protocol::REPORT_MODE_DRY;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_FAN_ONLY:
+            mode = protocol::REPORT_MODE_FAN;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_HEAT:
+            mode = protocol::REPORT_MODE_HEAT;
+            power = true;
+            break;
+        default:
+        case climate::CLIMATE_MODE_OFF:
+            /* In case of MODE_OFF we will not alter the last mode setting recieved from AC, see determine_mode() */
+            switch (this->mode_internal_)
+            {
+                case climate::CLIMATE_MODE_AUTO:
+                    mode = protocol::REPORT_MODE_AUTO;
+                    break;
+                case climate::CLIMATE_MODE_COOL:
+                    mode = protocol::REPORT_MODE_COOL;
+                    break;
+                case climate::CLIMATE_MODE_DRY:
+                    mode = protocol::REPORT_MODE_DRY;
+                    break;
+                case climate::CLIMATE_MODE_FAN_ONLY:
+                    mode = protocol::REPORT_MODE_FAN;
+                    break;
+                case climate::CLIMATE_MODE_HEAT:
+                    mode = protocol::REPORT_MODE_HEAT;
+                    break;
+            }
+            power = false;
+            break;
+    }
+
+    packet[protocol::REPORT_MODE_BYTE] |= (mode << protocol::REPORT_MODE_POS);
+    if (power)
+    {
+        packet[protocol::REPORT_PWR_BYTE] |= protocol::REPORT_PWR_MASK;
+    }
+
+    /* TARGET TEMPERATURE --------------------------------------------------------------------------- */
+    uint8_t target_temperature = ((((uint8_t)this->target_temperature) - protocol::REPORT_TEMP_SET_OFF) << protocol::REPORT_TEMP_SET_POS);
+    packet[protocol::REPORT_TEMP_SET_BYTE] |= (target_temperature & protocol::REPORT_TEMP_SET_MASK);
+
+    /* FAN SPEED --------------------------------------------------------------------------- */
+    /* below will default to AUTO */
+    uint8_t fanSpeed1 = 0;
+    uint8_t fanSpeed2 = 0;
+    bool    fanQuiet  = false;
+    bool    fanTurbo  = false;
+
+    if (this->custom_fan_mode == fan_modes::FAN_AUTO)
+    {
+        fanSpeed1 = 0;
+        fanSpeed2 = 0;
+        fanQuiet  = false;
+        fanTurbo  = false;
+    }
+    else if (this->custom_fan_mode == fan_modes::FAN_LOW)
+    {
+        fanSpeed1 = 1;
+        fanSpeed2 = 1;
+        fanQuiet  = false;
+        fanTurbo  = false;
+    }
+    else if (this->custom_fan_mode == fan_modes::FAN_QUIET)
+    {
+        fanSpeed1 = 1;
+        fanSpeed2 = 1;
+        fanQuiet  = true;
+        fanTurbo  = false;
+    }
+    else if (this->custom_fan_mode == fan_modes::FAN_MEDL)
+    {
+        fanSpeed1 = 2;
+        fanSpeed2 = 2;
+        fanQuiet  = false;
+        fanTurbo  = false;
+    }
+    else if (this->custom_fan_mode == fan_modes::FAN_MED)
+    {
+        fanSpeed1 = 3;
+        fanSpeed2 = 2;
+        fanQuiet  = false;
+        fanTurbo  = false;
+    }
+    else if (this->custom_fan_mode == fan_modes::FAN_MEDH)
+    {
+        fanSpeed1 = 4;
+        fanSpeed2 = 3;
+        fanQuiet  = false;
+        fanTurbo  = false;
+    }
+    else if (this->custom_fan_mode == fan_modes::FAN_HIGH)
+    {
+        fanSpeed1 = 5;
+        fanSpeed2 = 3;
+        fanQuiet  = false;
+        fanTurbo  = false;
+    }
+    else if (this->custom_fan_mode == fan_modes::FAN_TURBO)
+    {
+        fanSpeed1 = 5;
+        fanSpeed2 = 3;
+        fanQuiet  = false;
+        fanTurbo  = true;
+    }
+    else
+    {
+        fanSpeed1 = 0;
+        fanSpeed2 = 0;
+        fanQuiet  = false;
+        fanTurbo  = false;
+    }
+
+    packet[protocol::REPORT_FAN_SPD1_BYTE] |= (fanSpeed1 << protocol::REPORT_FAN_SPD1_POS);
+    packet[protocol::REPORT_FAN_SPD2_BYTE] |= (fanSpeed2 << protocol::REPORT_FAN_SPD2_POS);
+    if (fanTurbo)
+    {
+        packet[protocol::REPORT_FAN_TURBO_BYTE] |= protocol::REPORT_FAN_TURBO_MASK;
+    }
+    if (fanQuiet)
+    {
+        packet[protocol::REPORT_FAN_QUIET_BYTE] |= protocol::REPORT_FAN_QUIET_MASK;
+    }
+
+    /* VERTICAL SWING --------------------------------------------------------------------------- */
+    uint8_t mode_vertical_swing = protocol::REPORT_VSWING_OFF;
+    if (this->vertical_swing_state_ == vertical_swing_options::OFF)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_OFF;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::FULL)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_FULL;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::DOWN)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_DOWN;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::MIDD)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_MIDD;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::MID)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_MID;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::MIDU)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_MIDU;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::UP)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_UP;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::CDOWN)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_CDOWN;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::CMIDD)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_CMIDD;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::CMID)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_CMID;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::CMIDU)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_CMIDU;
+    }
+    else if (this->vertical_swing_state_ == vertical_swing_options::CUP)
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_CUP;
+    }
+    else
+    {
+        mode_vertical_swing = protocol::REPORT_VSWING_OFF;
+    }
+    packet[protocol::REPORT_VSWING_BYTE] |= (mode_vertical_swing << protocol::REPORT_VSWING_POS);
+
+    /* HORIZONTAL SWING --------------------------------------------------------------------------- */
+    uint8_t mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
+    if (this->horizontal_swing_state_ == horizontal_swing_options::OFF)
+    {
+        mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
+    }
+    else if (this->horizontal_swing_state_ == horizontal_swing_options::FULL)
+    {
+        mode_horizontal_swing = protocol::REPORT_HSWING_FULL;
+    }
+    else if (this->horizontal_swing_state_ == horizontal_swing_options::CLEFT)
+    {
+        mode_horizontal_swing = protocol::REPORT_HSWING_CLEFT;
+    }
+    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMIDL)
+    {
+        mode_horizontal_swing = protocol::REPORT_HSWING_CMIDL;
+    }
+    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMID)
+    {
+        mode_horizontal_swing = protocol::REPORT_HSWING_CMID;
+    }
+    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMIDR)
+    {
+        mode_horizontal_swing = protocol::REPORT_HSWING_CMIDR;
+    }
+    else if (this->horizontal_swing_state_ == horizontal_swing_options::CRIGHT)
+    {
+        mode_horizontal_swing = protocol::REPORT_HSWING_CRIGHT;
+    }
+    else
+    {
+        mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
+    }
+    packet[protocol::REPORT_HSWING_BYTE] |= (mode_horizontal_swing << protocol::REPORT_HSWING_POS);
+
+    /* DISPLAY --------------------------------------------------------------------------- */
+    uint8_t display_mode = protocol::REPORT_DISP_MODE_AUTO;
+    if (this->display_state_ == display_options::AUTO)
+    {
+        display_mode = protocol::REPORT_DISP_MODE_AUTO;
+        this->display_power_internal_ = true;
+    }
+    else if (this->display_state_ == display_options::SET)
+    {
+        display_mode = protocol::REPORT_DISP_MODE_SET;
+        this->display_power_internal_ = true;
+    }
+    else if (this->display_state_ == display_options::ACT)
+    {
+        display_mode = protocol::REPORT_DISP_MODE_ACT;
+        this->display_power_internal_ = true;
+    }
+    else if (this->display_state_ == display_options::OUT)
+    {
+        display_mode = protocol::REPORT_DISP_MODE_OUT;
+        this->display_power_internal_ = true;
+    }
+    else if (this->display_state_ == display_options::OFF)
+    {
+        /* we do not want to alter display setting - only turn it off */
+        this->display_power_internal_ = false;
+        if (this->display_mode_internal_ == display_options::AUTO)
+        {
+            display_mode = protocol::REPORT_DISP_MODE_AUTO;
+        }
+        else if (this->display_mode_internal_ == display_options::SET)
+        {
+            display_mode = protocol::REPORT_DISP_MODE_SET;
+        }
+        else if (this->display_mode_internal_ == display_options::ACT)
+        {
+            display_mode = protocol::REPORT_DISP_MODE_ACT;
+        }
+        else if (this->display_mode_internal_ == display_options::OUT)
+        {
+            display_mode = protocol::REPORT_DISP_MODE_OUT;
+        }
+        else
+        {
+            display_mode = protocol::REPORT_DISP_MODE_AUTO;
+        }
+    }
+    else
+    {
+        display_mode = protocol::REPORT_DISP_MODE_AUTO;
+        this->display_power_internal_ = true;
+    }
+
+    packet[protocol::REPORT_DISP_MODE_BYTE] |= (display_mode << protocol::REPORT_DISP_MODE_POS);
+
+    if (this->display_power_internal_)
+    {
+        packet[protocol::REPORT_DISP_ON_BYTE] |= protocol::REPORT_DISP_ON_MASK;
+    }
+
+    /* DISPLAY UNIT --------------------------------------------------------------------------- */
+    if (this->display_unit_state_ == display_unit_options::DEGF)
+    {
+        packet[protocol::REPORT_DISP_F_BYTE] |= protocol::REPORT_DISP_F_MASK;
+    }
+
+    /* PLASMA --------------------------------------------------------------------------- */
+    if (this->plasma_state_)
+    {
+        packet[protocol::REPORT_PLASMA1_BYTE] |= protocol::REPORT_PLASMA1_MASK;
+        packet[protocol::REPORT_PLASMA2_BYTE] |= protocol::REPORT_PLASMA2_MASK;
+    }
+
+    /* SLEEP --------------------------------------------------------------------------- */
+    if (this->sleep_state_)
+    {
+        packet[protocol::REPORT_SLEEP_BYTE] |= protocol::REPORT_SLEEP_MASK;
+    }
+
+    /* XFAN --------------------------------------------------------------------------- */
+    if (this->xfan_state_)
+    {
+        packet[protocol::REPORT_XFAN_BYTE] |= protocol::REPORT_XFAN_MASK;
+    }
+
+    /* SAVE --------------------------------------------------------------------------- */
+    if (this->save_state_)
+    {
+        packet[protocol::REPORT_SAVE_BYTE] |= protocol::REPORT_SAVE_MASK;
+    }
+    
+    /* Do the command, length */
+    packet.insert(packet.begin(), protocol::CMD_OUT_PARAMS_SET);
+    packet.insert(packet.begin(), protocol::SET_PACKET_LEN + 2); /* Add 2 bytes as we added a command and will add checksum */
+
+    /* Do checksum - sum of all bytes except sync and checksum itself% 0x100 
+       the module would be realized by the fact that we are using uint8_t*/
+    uint8_t checksum = 0;
+    for (uint8_t i = 0 ; i < packet.size() ; i++)
+    {
+        checksum += packet[i];
+    }
+    packet.push_back(checksum);
+
+    /* Do SYNC bytes */
+    packet.insert(packet.begin(), protocol::SYNC);
+    packet.insert(packet.begin(), protocol::SYNC);
+
+    return packet;
+}
+
+}  // namespace legacy
+
+int main(int argc, char **argv)
+{
+    double min_seconds = bench::min_seconds(argc, argv);
+    uint32_t i = 0;
+
+    /* OLD - the whole frame from option strings on every call, as every keep-alive did. Strings were set by the
+       entity callbacks, not per frame, so states are prepared up front */
+    static const size_t STATES = 60;
+    std::vector<legacy::SinclairACCNT> encoders(STATES);
+    for (size_t n = 0; n < STATES; n++)
+    {
+        legacy::SinclairACCNT &legacy = encoders[n];
+        legacy.update_ = (n & 1) ? legacy::ACUpdate::UpdateStart : legacy::ACUpdate::UpdateClear;
+        legacy.mode = (climate::ClimateMode) (1 + n % climate::CLIMATE_MODE_AUTO);
+        legacy.mode_internal_ = legacy.mode;
+        legacy.target_temperature = 16 + n % 15;
+        legacy.custom_fan_mode = *legacy::FAN_MODES[n % 8];
+        legacy.vertical_swing_state_ = *legacy::VERTICAL_SWING[n % 12];
+        legacy.horizontal_swing_state_ = *legacy::HORIZONTAL_SWING[n % 7];
+        legacy.display_state_ = *legacy::DISPLAY[n % 5];
+        legacy.display_mode_internal_ = legacy::display_options::AUTO;
+        legacy.display_unit_state_ = legacy::display_unit_options::DEGC;
+        legacy.display_power_internal_ = true;
+        legacy.plasma_state_ = false;
+        legacy.sleep_state_ = n & 2;
+        legacy.xfan_state_ = false;
+        legacy.save_state_ = false;
+    }
+    double per_legacy = bench::time_per_call([&]() {
+        std::vector<uint8_t> packet = encoders[i++ % STATES].send_packet();
+        bench::keep(packet);
+    }, min_seconds);
+    bench::report("legacy send_packet() encode", per_legacy * 1e9, "ns/frame");
+
+    /* NEW - SetFrame with all fields encoded, as the first frame after boot */
+    SetFrame frame;
+    frame.init();
+    ACSettings_t settings = {};
+    double per_full = bench::time_per_call([&]() {
+        i++;
+        settings.fan_mode = i % fan_modes::COUNT;
+        settings.sleep = i & 2;
+        frame.encode_update(i & 1, true);
+        frame.encode_mode(i % (protocol::REPORT_MODE_HEAT + 1), true);
+        frame.encode_target_temperature(16 + i % 15);
+        frame.encode_fan_mode(settings.fan_mode);
+        frame.encode_vertical_swing(i % vertical_swing_options::COUNT);
+        frame.encode_horizontal_swing(i % horizontal_swing_options::COUNT);
+        frame.encode_display(i % display_options::COUNT, display_options::AUTO);
+        frame.encode_flags(settings);
+        bench::keep(frame);
+    }, min_seconds);
+    bench::report("SetFrame encode, all fields", per_full * 1e9, "ns/frame");
+
+    /* and keep-alive, where only update flags and plain bits are patched */
+    double per_keep_alive = bench::time_per_call([&]() {
+        i++;
+        frame.encode_update(false, false);
+        frame.encode_flags(settings);
+        bench::keep(frame);
+    }, min_seconds);
+    bench::report("SetFrame encode, keep-alive", per_keep_alive * 1e9, "ns/frame");
+
+    bench::report("speedup, all fields", per_legacy / per_full, "x");
+    bench::report("speedup, keep-alive", per_legacy / per_keep_alive, "x");
+    return 0;
+}
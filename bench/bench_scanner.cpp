@@ -0,0 +1,250 @@
+// Old vs new recieve path - the byte at a time std::vector scanner the component used before serial_parse(),
+// both run over recorded report streams. Usage: bench_scanner [--quick] [recorded.bin] [--corrupted corrupted.bin]
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "bench.h"
+#include "esppac_core.h"
+
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+static const size_t STREAM_FRAMES = 1000;
+static const size_t CHUNK_MAX = 64;  /* same as RX_CHUNK_MAX of the component */
+
+static bool header_check(void *ctx, uint8_t len, uint8_t cmd)
+{
+    return is_valid_header(len, cmd);
+}
+
+/* SinclairAC::read_data() and the frame checks of SinclairACCNT::verify_packet() as they were before the fixed
+   frame buffer - every byte goes through available()/read_byte() and is pushed to a std::vector */
+class LegacyScanner {
+    public:
+        /* returns number of frames with valid checksum found in data */
+        size_t scan(const uint8_t *data, size_t len)
+        {
+            size_t frames = 0;
+            size_t pos = 0;
+            while (pos < len)
+            {
+                /* read_data() stops at a complete frame, loop() verifies it and restarts the state machine */
+                while (pos < len)
+                {
+                    if (this->state_ == LEGACY_COMPLETE)
+                    {
+                        break;
+                    }
+                    uint8_t c = data[pos++];
+
+                    if (this->state_ == LEGACY_RESTART)
+                    {
+                        this->data_.clear();
+                        this->state_ = LEGACY_WAIT_SYNC;
+                    }
+
+                    this->data_.push_back(c);
+                    if (this->data_.size() >= DATA_MAX)
+                    {
+                        this->data_.clear();
+                        continue;
+                    }
+                    switch (this->state_)
+                    {
+                        case LEGACY_WAIT_SYNC:
+                            if (c != 0x7E &&
+                                this->data_.size() > 2 &&
+                                this->data_[this->data_.size()-2] == 0x7E &&
+                                this->data_[this->data_.size()-3] == 0x7E)
+                            {
+                                this->data_.clear();
+
+                                this->data_.push_back(0x7E);
+                                this->data_.push_back(0x7E);
+                                this->data_.push_back(c);
+
+                                this->frame_size_ = c;
+                                this->state_ = LEGACY_RECIEVE;
+                            }
+                            break;
+                        case LEGACY_RECIEVE:
+                            this->frame_size_--;
+                            if (this->frame_size_ == 0)
+                            {
+                                this->state_ = LEGACY_COMPLETE;
+                            }
+                            break;
+                        default:
+                            break;
+                    }
+                }
+                if (this->state_ == LEGACY_COMPLETE)
+                {
+                    this->state_ = LEGACY_RESTART;
+                    if (this->verify())
+                    {
+                        frames++;
+                    }
+                }
+            }
+            return frames;
+        }
+
+    protected:
+        enum LegacyState_t { LEGACY_WAIT_SYNC, LEGACY_RECIEVE, LEGACY_COMPLETE, LEGACY_RESTART };
+
+        bool verify() const
+        {
+            if (this->data_.size() < 5)
+            {
+                return false;
+            }
+            uint8_t checksum = 0;
+            for (uint8_t i = 2; i < this->data_.size() - 1; i++)
+            {
+                checksum += this->data_[i];
+            }
+            return checksum == this->data_[this->data_.size()-1];
+        }
+
+        std::vector<uint8_t> data_;
+        uint8_t frame_size_ = 0;
+        LegacyState_t state_ = LEGACY_WAIT_SYNC;
+};
+
+/* serial_parse() fed with UART sized chunks, as SinclairAC::read_data() does now */
+static size_t scan_chunks(SerialProcess_t &process, const uint8_t *data, size_t len)
+{
+    size_t frames = 0;
+    for (size_t pos = 0; pos < len;)
+    {
+        size_t chunk = std::min(len - pos, CHUNK_MAX);
+        size_t end = pos + chunk;
+        while (pos < end)
+        {
+            FrameEvent event;
+            pos += serial_parse(process, data + pos, end - pos, header_check, nullptr, event);
+            if (event == FrameEvent::FRAME)
+            {
+                frames++;
+                process.pending = nullptr;
+            }
+        }
+    }
+    return frames;
+}
+
+/* Unit reports as AC sends them, target and room temperature changing from report to report, with line noise
+   between some of them */
+static std::vector<uint8_t> report_stream(bool noise)
+{
+    std::vector<uint8_t> stream;
+    SetFrame report;
+    report.init(protocol::CMD_IN_UNIT_REPORT);
+    ACSettings_t settings = {};
+    settings.fan_mode = fan_modes::FAN_AUTO;
+    report.encode_mode(protocol::REPORT_MODE_COOL, true);
+    report.encode_fan_mode(settings.fan_mode);
+    report.encode_vertical_swing(vertical_swing_options::OFF);
+    report.encode_horizontal_swing(horizontal_swing_options::OFF);
+    report.encode_display(display_options::AUTO, display_options::AUTO);
+    report.encode_flags(settings);
+    for (size_t i = 0; i < STREAM_FRAMES; i++)
+    {
+        report.encode_target_temperature(16 + i % 15);
+        report.encode_current_temperature(20.0f + (i % 20) / 2.0f);
+        stream.insert(stream.end(), report.data(), report.data() + report.size());
+        if (noise && i % 7 == 0)
+        {
+            static const uint8_t NOISE[] = {0x7E, 0x7E, 0xF0, 0x7E, 0x13, 0x55};
+            stream.insert(stream.end(), NOISE, NOISE + sizeof(NOISE));
+        }
+    }
+    return stream;
+}
+
+static std::vector<uint8_t> load(const char *path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return data;
+    }
+    uint8_t buf[256];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+    {
+        data.insert(data.end(), buf, buf + len);
+    }
+    fclose(file);
+    return data;
+}
+
+/* runs both scanners over the stream, reports bytes/us of each, the speedup and frames found by each,
+   on clean data both have to find the same frames */
+static bool compare(const char *name, const std::vector<uint8_t> &stream, bool clean, double min_seconds)
+{
+    char label[64];
+
+    LegacyScanner legacy;
+    size_t legacy_frames = legacy.scan(stream.data(), stream.size());
+    double per_legacy = bench::time_per_call([&]() {
+        bench::keep(legacy.scan(stream.data(), stream.size()));
+    }, min_seconds);
+
+    SerialProcess_t process = {};
+    size_t frames = scan_chunks(process, stream.data(), stream.size());
+    double per_parse = bench::time_per_call([&]() {
+        bench::keep(scan_chunks(process, stream.data(), stream.size()));
+    }, min_seconds);
+
+    snprintf(label, sizeof(label), "%s, legacy scanner", name);
+    bench::report(label, stream.size() / per_legacy / 1e6, "bytes/us");
+    snprintf(label, sizeof(label), "%s, serial_parse", name);
+    bench::report(label, stream.size() / per_parse / 1e6, "bytes/us");
+    snprintf(label, sizeof(label), "%s, speedup", name);
+    bench::report(label, per_legacy / per_parse, "x");
+    printf("%-48s %14zu / %zu frames\n", "  found by legacy scanner / serial_parse", legacy_frames, frames);
+
+    /* a broken frame start makes the old scanner swallow the frames behind it, noise is only measured */
+    if (frames == 0 || (clean && frames != legacy_frames))
+    {
+        printf("%s: serial_parse found %zu frames, legacy scanner %zu\n", name, frames, legacy_frames);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    double min_seconds = bench::min_seconds(argc, argv);
+    bool ok = true;
+
+    ok &= compare("reports", report_stream(false), true, min_seconds);
+    ok &= compare("reports with noise", report_stream(true), false, min_seconds);
+    bool corrupted = false;
+    for (int i = 1; i < argc; i++)
+    {
+        /* --corrupted marks the next file as a stream with broken frames, e.g. tests/data/corrupted_stream.bin */
+        if (strcmp(argv[i], "--corrupted") == 0)
+        {
+            corrupted = true;
+            continue;
+        }
+        if (argv[i][0] == '-')
+        {
+            continue;
+        }
+        std::vector<uint8_t> recorded = load(argv[i]);
+        if (recorded.empty())
+        {
+            printf("Cannot read %s\n", argv[i]);
+            return 1;
+        }
+        ok &= compare(corrupted ? "corrupted" : "recorded", recorded, !corrupted, min_seconds);
+        corrupted = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import button
+from esphome.const import ENTITY_CATEGORY_DIAGNOSTIC
+
+from .climate import sinclair_ac_ns, SinclairAC
+
+CONF_SINCLAIR_AC_ID = "sinclair_ac_id"
+
+SinclairACButton = sinclair_ac_ns.class_(
+    "SinclairACButton", button.Button, cg.Component
+)
+
+# logs the frames captured by the AC, needs capture: set in its climate config
+CONFIG_SCHEMA = button.button_schema(
+    SinclairACButton,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+).extend(
+    {
+        cv.GenerateID(CONF_SINCLAIR_AC_ID): cv.use_id(SinclairAC),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = await button.new_button(config)
+    await cg.register_component(var, config)
+    parent = await cg.get_variable(config[CONF_SINCLAIR_AC_ID])
+    cg.add(var.set_parent(parent))
@@ -2,6 +2,11 @@
 
 from esphome.const import (
     CONF_ID,
+    CONF_UPDATE_INTERVAL,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_MILLISECOND,
 )
 import esphome.codegen as cg
 import esphome.config_validation as cv
@@ -23,6 +28,7 @@ SinclairACSwitch = sinclair_ac_ns.class_(
 SinclairACSelect = sinclair_ac_ns.class_(
     "SinclairACSelect", select.Select, cg.Component
 )
+StatisticsSensor = sinclair_ac_ns.enum("StatisticsSensor", is_class=True)
 
 
 CONF_HORIZONTAL_SWING_SELECT    = "horizontal_swing_select"
@@ -37,6 +43,20 @@ CONF_SAVE_SWITCH                = "save_switch"
 
 CONF_CURRENT_TEMPERATURE_SENSOR = "current_temperature_sensor"
 
+CONF_UPDATE_COALESCE_WINDOW     = "update_coalesce_window"
+CONF_FAST_REFRESH_INTERVAL      = "fast_refresh_interval"
+CONF_IDLE_REFRESH_INTERVAL      = "idle_refresh_interval"
+CONF_INITIALIZING_REFRESH_MAX   = "initializing_refresh_max"
+
+CONF_APPLY_LATENCY_SENSOR       = "apply_latency_sensor"
+CONF_APPLY_RETRIES_SENSOR       = "apply_retries_sensor"
+
+CONF_STATISTICS                 = "statistics"
+CONF_PROFILE_LOOP               = "profile_loop"
+
+CONF_CAPTURE                    = "capture"
+CONF_CAPTURE_FRAMES             = "frames"
+
 HORIZONTAL_SWING_OPTIONS = [
     "0 - OFF",
     "1 - Swing - Full",
@@ -76,6 +96,66 @@ DISPLAY_UNIT_OPTIONS = [
     "F",
 ]
 
+def statistics_counter_schema():
+    return sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+def statistics_rate_schema():
+    return sensor.sensor_schema(
+        unit_of_measurement="frames/s",
+        accuracy_decimals=2,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+def statistics_time_schema():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+# this must be same as StatisticsSensor in esppac.h
+STATISTICS_SENSORS = {
+    "rx_frame_rate":        (StatisticsSensor.RX_RATE,               statistics_rate_schema()),
+    "tx_frame_rate":        (StatisticsSensor.TX_RATE,               statistics_rate_schema()),
+    "checksum_errors":      (StatisticsSensor.CHECKSUM_ERRORS,       statistics_counter_schema()),
+    "length_errors":        (StatisticsSensor.LENGTH_ERRORS,         statistics_counter_schema()),
+    "resyncs":              (StatisticsSensor.RESYNCS,               statistics_counter_schema()),
+    "dropped_frames":       (StatisticsSensor.DROPPED_FRAMES,        statistics_counter_schema()),
+    "timeout_frames":       (StatisticsSensor.TIMEOUT_FRAMES,        statistics_counter_schema()),
+    "inactive_timeouts":    (StatisticsSensor.INACTIVE_TIMEOUTS,     statistics_counter_schema()),
+    "round_trip_time":      (StatisticsSensor.ROUND_TRIP_TIME,       statistics_time_schema()),
+    "tx_latency_p50":       (StatisticsSensor.TX_LATENCY_P50,        statistics_time_schema()),
+    "tx_latency_p99":       (StatisticsSensor.TX_LATENCY_P99,        statistics_time_schema()),
+    "resync_latency":       (StatisticsSensor.RESYNC_LATENCY,        statistics_time_schema()),
+    "unknown_packets":      (StatisticsSensor.UNKNOWN_PACKETS,       statistics_counter_schema()),
+    "identical_reports":    (StatisticsSensor.IDENTICAL_REPORTS,     statistics_counter_schema()),
+    "publishes_emitted":    (StatisticsSensor.PUBLISHES_EMITTED,     statistics_counter_schema()),
+    "publishes_suppressed": (StatisticsSensor.PUBLISHES_SUPPRESSED,  statistics_counter_schema()),
+    "coalesced_changes":    (StatisticsSensor.COALESCED_CHANGES,     statistics_counter_schema()),
+    "update_retries":       (StatisticsSensor.UPDATE_RETRIES,        statistics_counter_schema()),
+    "failed_updates":       (StatisticsSensor.FAILED_UPDATES,        statistics_counter_schema()),
+}
+
+statistics_schema = cv.Schema(
+    {
+        cv.Optional(CONF_UPDATE_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        **{cv.Optional(key): schema for key, (_, schema) in STATISTICS_SENSORS.items()},
+    }
+)
+
+# last frames of this AC kept for dumping by the sinclair_ac button platform
+capture_schema = cv.Schema(
+    {
+        cv.Optional(CONF_CAPTURE_FRAMES, default=16): cv.int_range(min=1, max=255),
+    }
+)
+
 switch_schema = switch.switch_schema(switch.Switch).extend(cv.COMPONENT_SCHEMA).extend(
     {cv.GenerateID(): cv.declare_id(SinclairACSwitch)}
 )
@@ -101,6 +181,24 @@ CONFIG_SCHEMA = cv.All(
         {
             cv.GenerateID(): cv.declare_id(SinclairACCNT),
             cv.Optional(CONF_CURRENT_TEMPERATURE_SENSOR): cv.use_id(sensor.Sensor),
+            cv.Optional(CONF_UPDATE_COALESCE_WINDOW, default="50ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_FAST_REFRESH_INTERVAL, default="300ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_IDLE_REFRESH_INTERVAL, default="500ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_INITIALIZING_REFRESH_MAX, default="5s"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_APPLY_LATENCY_SENSOR): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MILLISECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_APPLY_RETRIES_SENSOR): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_STATISTICS): statistics_schema,
+            cv.Optional(CONF_PROFILE_LOOP, default=False): cv.boolean,
+            cv.Optional(CONF_CAPTURE): capture_schema,
         }
     ),
 )
@@ -112,6 +210,18 @@ async def to_code(config):
     await cg.register_component(var, config)
     await uart.register_uart_device(var, config)
 
+    if config[CONF_PROFILE_LOOP]:
+        cg.add_define("USE_SINCLAIR_AC_PROFILER")
+
+    if CONF_CAPTURE in config:
+        cg.add_define("USE_SINCLAIR_AC_CAPTURE")
+        cg.add(var.set_capture_frames(config[CONF_CAPTURE][CONF_CAPTURE_FRAMES]))
+
+    cg.add(var.set_update_coalesce_window(config[CONF_UPDATE_COALESCE_WINDOW]))
+    cg.add(var.set_fast_refresh_interval(config[CONF_FAST_REFRESH_INTERVAL]))
+    cg.add(var.set_idle_refresh_interval(config[CONF_IDLE_REFRESH_INTERVAL]))
+    cg.add(var.set_initializing_refresh_max(config[CONF_INITIALIZING_REFRESH_MAX]))
+
     if CONF_HORIZONTAL_SWING_SELECT in config:
         conf = config[CONF_HORIZONTAL_SWING_SELECT]
         hswing_select = await select.new_select(conf, options=HORIZONTAL_SWING_OPTIONS)
@@ -139,6 +249,22 @@ async def to_code(config):
     if CONF_CURRENT_TEMPERATURE_SENSOR in config:
         sens = await cg.get_variable(config[CONF_CURRENT_TEMPERATURE_SENSOR])
         cg.add(var.set_current_temperature_sensor(sens))
+
+    if CONF_APPLY_LATENCY_SENSOR in config:
+        sens = await sensor.new_sensor(config[CONF_APPLY_LATENCY_SENSOR])
+        cg.add(var.set_apply_latency_sensor(sens))
+
+    if CONF_APPLY_RETRIES_SENSOR in config:
+        sens = await sensor.new_sensor(config[CONF_APPLY_RETRIES_SENSOR])
+        cg.add(var.set_apply_retries_sensor(sens))
+
+    if CONF_STATISTICS in config:
+        conf = config[CONF_STATISTICS]
+        cg.add(var.set_statistics_interval(conf[CONF_UPDATE_INTERVAL]))
+        for key, (statistic, _) in STATISTICS_SENSORS.items():
+            if key in conf:
+                sens = await sensor.new_sensor(conf[key])
+                cg.add(var.set_statistics_sensor(statistic, sens))
         
     for s in [CONF_PLASMA_SWITCH, CONF_SLEEP_SWITCH, CONF_XFAN_SWITCH, CONF_SAVE_SWITCH]:
         if s in config:
@@ -2,6 +2,9 @@
 #include "esppac.h"
 
 #include "esphome/core/log.h"
+#ifdef USE_LOGGER
+#include "esphome/components/logger/logger.h"
+#endif
 
 namespace esphome {
 namespace sinclair_ac {
@@ -23,14 +26,10 @@ climate::ClimateTraits SinclairAC::traits()
     traits.set_supported_modes({climate::CLIMATE_MODE_OFF, climate::CLIMATE_MODE_AUTO, climate::CLIMATE_MODE_COOL,
                                 climate::CLIMATE_MODE_HEAT, climate::CLIMATE_MODE_FAN_ONLY, climate::CLIMATE_MODE_DRY});
 
-    traits.add_supported_custom_fan_mode(fan_modes::FAN_AUTO);
-    traits.add_supported_custom_fan_mode(fan_modes::FAN_QUIET);
-    traits.add_supported_custom_fan_mode(fan_modes::FAN_LOW);
-    traits.add_supported_custom_fan_mode(fan_modes::FAN_MEDL);
-    traits.add_supported_custom_fan_mode(fan_modes::FAN_MED);
-    traits.add_supported_custom_fan_mode(fan_modes::FAN_MEDH);
-    traits.add_supported_custom_fan_mode(fan_modes::FAN_HIGH);
-    traits.add_supported_custom_fan_mode(fan_modes::FAN_TURBO);
+    for (const char *fan_mode : fan_modes::NAMES)
+    {
+        traits.add_supported_custom_fan_mode(fan_mode);
+    }
 
     traits.set_supported_swing_modes({climate::CLIMATE_SWING_OFF, climate::CLIMATE_SWING_BOTH,
                                       climate::CLIMATE_SWING_VERTICAL, climate::CLIMATE_SWING_HORIZONTAL});
@@ -41,185 +40,373 @@ climate::ClimateTraits SinclairAC::traits()
 void SinclairAC::setup()
 {
   // Initialize times
-    this->init_time_ = millis();
-    this->last_packet_sent_ = millis();
+    this->init_time_ = this->clock_();
+    this->last_packet_sent_ = this->clock_();
+    this->last_read_ = this->clock_();
+    this->statistics_published_ = this->clock_();
+
+#ifdef USE_SINCLAIR_AC_PROFILER
+    for (StageProfile_t &profile : this->profile_)
+    {
+        profile = {{10, {}}, 0};  /* buckets from below 10 us up to 640 us and above */
+    }
+    this->set_interval("profile", PROFILE_LOG_INTERVAL, [this]() { this->log_profile(); });
+#endif
+
+#ifdef USE_SINCLAIR_AC_CAPTURE
+    /* allocated once here, capturing itself only copies */
+    if (this->capture_frames_ > 0)
+    {
+        this->capture_.reset(new CaptureEntry_t[this->capture_frames_]);
+    }
+#endif
 
     ESP_LOGI(TAG, "Sinclair AC component v%s starting...", VERSION);
 }
 
 void SinclairAC::loop()
 {
-    read_data();  // Read data from UART (if there is any)
+    {
+        SINCLAIR_AC_PROFILE(ProfileStage::READ_DATA);
+        read_data();  // Read data from UART (if there is any)
+    }
+
+    /* not a scheduler interval - rates are computed from clock_() and have to be published by the same clock */
+    if (this->statistics_enabled_ && this->clock_() - this->statistics_published_ >= this->statistics_interval_)
+    {
+        this->publish_statistics();
+    }
 }
 
 void SinclairAC::read_data()
 {
-    while (available())  // Read while data is available
+    /* partial frame with no more data for READ_TIMEOUT will never complete - discard it */
+    if (this->serialProcess_.state == STATE_RECIEVE &&
+        this->rx_chunk_pos_ >= this->rx_chunk_len_ &&
+        available() <= 0 &&
+        this->clock_() - this->last_read_ > READ_TIMEOUT)
     {
-        /* If we had a packet or a packet had not been decoded yet - do not recieve more data */
-        if (this->serialProcess_.state == STATE_COMPLETE)
+        ESP_LOGV(TAG, "Dropping incomplete packet (timeout)");
+        serial_timeout(this->serialProcess_);
+        this->mark_resync();
+    }
+
+    while (true)
+    {
+        /* refill the chunk buffer only when previous chunk was fully consumed */
+        if (this->rx_chunk_pos_ >= this->rx_chunk_len_)
         {
-            break;
+            int avail = available();
+            if (avail <= 0)
+            {
+                break;
+            }
+            size_t len = std::min((size_t) avail, (size_t) RX_CHUNK_MAX);
+            if (!this->read_array(this->rx_chunk_, len))
+            {
+                break;
+            }
+            this->rx_chunk_len_ = len;
+            this->rx_chunk_pos_ = 0;
+            this->last_read_ = this->clock_();
         }
-        uint8_t c;
-        this->read_byte(&c);  // Store in receive buffer
 
-        if (this->serialProcess_.state == STATE_RESTART)
+        size_t len = this->rx_chunk_len_ - this->rx_chunk_pos_;
+        if (this->serialProcess_.pending != nullptr && this->serialProcess_.state == STATE_RECIEVE)
         {
-            this->serialProcess_.data.clear();
-            this->serialProcess_.state = STATE_WAIT_SYNC;
+            /* both slots busy - the last byte of the frame being filled waits until the pending frame is handled,
+               completing it now would drop the pending one */
+            if (this->serialProcess_.frame_size <= 1)
+            {
+                break;
+            }
+            len = std::min(len, (size_t) this->serialProcess_.frame_size - 1);
         }
-        
-        this->serialProcess_.data.push_back(c);
-        if (this->serialProcess_.data.size() >= DATA_MAX)
+        this->rx_chunk_pos_ += parse_data(this->rx_chunk_ + this->rx_chunk_pos_, len);
+    }
+}
+
+bool SinclairAC::check_header(void *ctx, uint8_t len, uint8_t cmd)
+{
+    return ((SinclairAC *) ctx)->is_valid_header(len, cmd);
+}
+
+size_t SinclairAC::parse_data(const uint8_t *data, size_t len)
+{
+    uint8_t fill_slot = this->serialProcess_.fill_slot;
+    uint32_t dropped_cnt = this->serialProcess_.dropped_cnt;
+
+    FrameEvent event;
+    size_t cnt = serial_parse(this->serialProcess_, data, len, &SinclairAC::check_header, this, event);
+
+    switch (event)
+    {
+        case FrameEvent::NONE:
+            break;
+        case FrameEvent::LENGTH_ERROR:
         {
-            this->serialProcess_.data.clear();
-            continue;
+#ifdef USE_SINCLAIR_AC_CAPTURE
+            /* LEN was the last byte consumed */
+            const uint8_t start[] = {0x7E, 0x7E, data[cnt - 1]};
+            this->capture_packet(start, sizeof(start), CaptureKind::RX_LENGTH_ERROR);
+#endif
+            this->link_stats_.length_errors++;
+            this->mark_resync();
+            break;
         }
-        switch (this->serialProcess_.state)
+        case FrameEvent::HEADER_ERROR:
         {
-            case STATE_WAIT_SYNC:
-                /* Frame begins with 0x7E 0x7E LEN CMD
-                   LEN - frame length in bytes
-                   CMD - command
-                 */
-                if (c != 0x7E && 
-                    this->serialProcess_.data.size() > 2 && 
-                    this->serialProcess_.data[this->serialProcess_.data.size()-2] == 0x7E && 
-                    this->serialProcess_.data[this->serialProcess_.data.size()-3] == 0x7E)
-                {
-                    this->serialProcess_.data.clear();
-
-                    this->serialProcess_.data.push_back(0x7E);
-                    this->serialProcess_.data.push_back(0x7E);
-                    this->serialProcess_.data.push_back(c);
-
-                    this->serialProcess_.frame_size = c;
-                    this->serialProcess_.state = STATE_RECIEVE;
-                }
-                break;
-            case STATE_RECIEVE:
-                this->serialProcess_.frame_size--;
-                if (this->serialProcess_.frame_size == 0)
-                {
-                    /* WE HAVE A FRAME FROM AC */
-                    this->serialProcess_.state = STATE_COMPLETE;
-                }
-                break;
-            case STATE_RESTART:
-            case STATE_COMPLETE:
-                break;
-            default:
-                this->serialProcess_.state = STATE_WAIT_SYNC;
-                this->serialProcess_.data.clear();
-                break;
+            const SerialFrame_t &frame = this->serialProcess_.slot[fill_slot];
+            ESP_LOGV(TAG, "Dropping invalid packet (length %02X for command [%02X])", frame.data[2], data[0]);
+#ifdef USE_SINCLAIR_AC_CAPTURE
+            const uint8_t start[] = {frame.data[0], frame.data[1], frame.data[2], data[0]};
+            this->capture_packet(start, sizeof(start), CaptureKind::RX_LENGTH_ERROR);
+#endif
+            this->link_stats_.length_errors++;
+            this->mark_resync();
+            break;
+        }
+        case FrameEvent::CHECKSUM_ERROR:
+        {
+            ESP_LOGD(TAG, "Dropping invalid packet (checksum)");
+#ifdef USE_SINCLAIR_AC_CAPTURE
+            const SerialFrame_t &frame = this->serialProcess_.slot[fill_slot];
+            this->capture_packet(frame.data, frame.data_cnt, CaptureKind::RX_CHECKSUM_ERROR);
+#endif
+            this->link_stats_.checksum_errors++;
+            this->mark_resync();
+            break;
         }
+        case FrameEvent::FRAME:
+            this->link_stats_.rx_frames++;
+            if (this->serialProcess_.dropped_cnt != dropped_cnt)
+            {
+                ESP_LOGV(TAG, "Dropping unhandled frame, no free slot");
+            }
+            if (this->resyncing_)
+            {
+                this->resyncing_ = false;
+                this->resync_latency_ = this->clock_() - this->resync_start_;
+                ESP_LOGD(TAG, "Link resynced after %u ms", (unsigned) this->resync_latency_);
+            }
+            break;
+    }
+    return cnt;
+}
+
+void SinclairAC::replay_packet(const std::string &hex)
+{
+    uint8_t data[DATA_MAX];
+    size_t len = parse_hex(hex.c_str(), data, sizeof(data));
+    if (len == 0)
+    {
+        ESP_LOGW(TAG, "Nothing to replay, malformed hex data");
+        return;
+    }
+
+    ESP_LOGI(TAG, "Replaying %u bytes", (unsigned) len);
+    /* own framing state - frame being recieved from AC and link statistics are not touched,
+       every complete frame is handled right away, so several frames in one string are fine */
+    SerialProcess_t process = {};
+    for (size_t pos = 0; pos < len;)
+    {
+        FrameEvent event;
+        pos += serial_parse(process, data + pos, len - pos, &SinclairAC::check_header, this, event);
+        if (event == FrameEvent::FRAME)
+        {
+            this->replay_frame(FrameView{process.pending->data, process.pending->data_cnt});
+            process.pending = nullptr;
+        }
+        else if (event != FrameEvent::NONE)
+        {
+            ESP_LOGW(TAG, "Replayed data has an invalid frame at byte %u", (unsigned) pos);
+        }
+    }
+    if (process.state == STATE_RECIEVE)
+    {
+        ESP_LOGW(TAG, "Replayed data ends with an incomplete frame");
+    }
+}
 
+void SinclairAC::mark_resync()
+{
+    /* measure from the first dropped frame until a valid frame is recieved again */
+    if (!this->resyncing_)
+    {
+        this->link_stats_.resyncs++;
+        this->resyncing_ = true;
+        this->resync_start_ = this->clock_();
     }
 }
 
-void SinclairAC::update_current_temperature(float temperature)
+bool SinclairAC::update_current_temperature(float temperature)
 {
     if (temperature > TEMPERATURE_THRESHOLD) {
         ESP_LOGW(TAG, "Received out of range inside temperature: %f", temperature);
-        return;
+        return false;
     }
 
+    bool changed = this->current_temperature != temperature;
     this->current_temperature = temperature;
+    return changed;
 }
 
-void SinclairAC::update_target_temperature(float temperature)
+bool SinclairAC::update_target_temperature(float temperature)
 {
     if (temperature > TEMPERATURE_THRESHOLD) {
         ESP_LOGW(TAG, "Received out of range target temperature %.2f", temperature);
-        return;
+        return false;
     }
 
+    bool changed = this->target_temperature != temperature;
     this->target_temperature = temperature;
+    return changed;
 }
 
-void SinclairAC::update_swing_horizontal(const std::string &swing)
+bool SinclairAC::update_swing_horizontal(uint8_t swing)
 {
-    this->horizontal_swing_state_ = swing;
+    bool changed = this->settings_.horizontal_swing != swing;
+    this->settings_.horizontal_swing = swing;
+    return changed;
+}
 
-    if (this->horizontal_swing_select_ != nullptr &&
-        this->horizontal_swing_select_->state != this->horizontal_swing_state_)
-    {
-        this->horizontal_swing_select_->publish_state(this->horizontal_swing_state_);
-    }
+bool SinclairAC::update_swing_vertical(uint8_t swing)
+{
+    bool changed = this->settings_.vertical_swing != swing;
+    this->settings_.vertical_swing = swing;
+    return changed;
 }
 
-void SinclairAC::update_swing_vertical(const std::string &swing)
+bool SinclairAC::update_display(uint8_t display)
 {
-    this->vertical_swing_state_ = swing;
+    bool changed = this->settings_.display != display;
+    this->settings_.display = display;
+    return changed;
+}
 
-    if (this->vertical_swing_select_ != nullptr && 
-        this->vertical_swing_select_->state != this->vertical_swing_state_)
-    {
-        this->vertical_swing_select_->publish_state(this->vertical_swing_state_);
-    }
+bool SinclairAC::update_display_unit(uint8_t display_unit)
+{
+    bool changed = this->settings_.display_unit != display_unit;
+    this->settings_.display_unit = display_unit;
+    return changed;
 }
 
-void SinclairAC::update_display(const std::string &display)
+bool SinclairAC::update_plasma(bool plasma)
 {
-    this->display_state_ = display;
+    bool changed = this->settings_.plasma != plasma;
+    this->settings_.plasma = plasma;
+    return changed;
+}
 
-    if (this->display_select_ != nullptr && 
-        this->display_select_->state != this->display_state_)
-    {
-        this->display_select_->publish_state(this->display_state_);
-    }
+bool SinclairAC::update_sleep(bool sleep)
+{
+    bool changed = this->settings_.sleep != sleep;
+    this->settings_.sleep = sleep;
+    return changed;
 }
 
-void SinclairAC::update_display_unit(const std::string &display_unit)
+bool SinclairAC::update_xfan(bool xfan)
 {
-    this->display_unit_state_ = display_unit;
+    bool changed = this->settings_.xfan != xfan;
+    this->settings_.xfan = xfan;
+    return changed;
+}
 
-    if (this->display_unit_select_ != nullptr && 
-        this->display_unit_select_->state != this->display_unit_state_)
-    {
-        this->display_unit_select_->publish_state(this->display_unit_state_);
-    }
+bool SinclairAC::update_save(bool save)
+{
+    bool changed = this->settings_.save != save;
+    this->settings_.save = save;
+    return changed;
 }
 
-void SinclairAC::update_plasma(bool plasma)
+/*
+ * Publish entities which state was marked as changed in dirty mask (see report_fields)
+ */
+void SinclairAC::publish_changes(uint16_t dirty)
 {
-    this->plasma_state_ = plasma;
+    dirty |= this->pending_publish_;
+    this->pending_publish_ = 0;
 
-    if (this->plasma_switch_ != nullptr)
+    if (dirty & report_fields::CLIMATE)
+    {
+        this->publish_state();
+        this->publishes_emitted_++;
+    }
+    else
     {
-        this->plasma_switch_->publish_state(this->plasma_state_);
+        this->publishes_suppressed_++;
     }
+
+    this->publish_settings(dirty);
 }
 
-void SinclairAC::update_sleep(bool sleep)
+void SinclairAC::publish_settings(uint16_t dirty)
 {
-    this->sleep_state_ = sleep;
+    this->publish_select(this->vertical_swing_select_, dirty & report_fields::VERTICAL_SWING,
+                         vertical_swing_options::NAMES[this->settings_.vertical_swing]);
+    this->publish_select(this->horizontal_swing_select_, dirty & report_fields::HORIZONTAL_SWING,
+                         horizontal_swing_options::NAMES[this->settings_.horizontal_swing]);
+    this->publish_select(this->display_select_, dirty & report_fields::DISPLAY,
+                         display_options::NAMES[this->settings_.display]);
+    this->publish_select(this->display_unit_select_, dirty & report_fields::DISPLAY_UNIT,
+                         display_unit_options::NAMES[this->settings_.display_unit]);
+
+    this->publish_switch(this->plasma_switch_, dirty & report_fields::PLASMA, this->settings_.plasma);
+    this->publish_switch(this->sleep_switch_, dirty & report_fields::SLEEP, this->settings_.sleep);
+    this->publish_switch(this->xfan_switch_, dirty & report_fields::XFAN, this->settings_.xfan);
+    this->publish_switch(this->save_switch_, dirty & report_fields::SAVE, this->settings_.save);
+}
 
-    if (this->sleep_switch_ != nullptr)
+void SinclairAC::publish_select(select::Select *select, bool changed, const char *option)
+{
+    if (select == nullptr)
+        return;
+
+    /* select publishes its own state when changed by user, so it may already show the option */
+    if (changed && select->state != option)
+    {
+        select->publish_state(option);
+        this->publishes_emitted_++;
+    }
+    else
     {
-        this->sleep_switch_->publish_state(this->sleep_state_);
+        this->publishes_suppressed_++;
     }
 }
 
-void SinclairAC::update_xfan(bool xfan)
+void SinclairAC::publish_switch(switch_::Switch *sw, bool changed, bool state)
 {
-    this->xfan_state_ = xfan;
+    if (sw == nullptr)
+        return;
 
-    if (this->xfan_switch_ != nullptr)
+    if (changed)
     {
-        this->xfan_switch_->publish_state(this->xfan_state_);
+        sw->publish_state(state);
+        this->publishes_emitted_++;
     }
+    else
+    {
+        this->publishes_suppressed_++;
+    }
+}
+
+/*
+ * Select or switch changed by user while the change can not be sent to AC - it goes back to the known setting.
+ * Not published right away, other callbacks of the entity would get the rejected state after the restored one.
+ */
+void SinclairAC::reject_change(uint16_t field)
+{
+    ESP_LOGW(TAG, "AC is not ready, change rejected");
+    this->rejected_changes_ |= field;
 }
 
-void SinclairAC::update_save(bool save)
+void SinclairAC::publish_rejected()
 {
-    this->save_state_ = save;
+    if (this->rejected_changes_ == 0)
+        return;
 
-    if (this->save_switch_ != nullptr)
-    {
-        this->save_switch_->publish_state(this->save_state_);
-    }
+    this->publish_settings(this->rejected_changes_);
+    this->rejected_changes_ = 0;
 }
 
 climate::ClimateAction SinclairAC::determine_action()
@@ -259,9 +446,9 @@ void SinclairAC::set_vertical_swing_select(select::Select *vertical_swing_select
 {
     this->vertical_swing_select_ = vertical_swing_select;
     this->vertical_swing_select_->add_on_state_callback([this](const std::string &value, size_t index) {
-        if (value == this->vertical_swing_state_)
+        if (index == this->settings_.vertical_swing)
             return;
-        this->on_vertical_swing_change(value);
+        this->on_vertical_swing_change(index);
     });
 }
 
@@ -269,9 +456,9 @@ void SinclairAC::set_horizontal_swing_select(select::Select *horizontal_swing_se
 {
     this->horizontal_swing_select_ = horizontal_swing_select;
     this->horizontal_swing_select_->add_on_state_callback([this](const std::string &value, size_t index) {
-        if (value == this->horizontal_swing_state_)
+        if (index == this->settings_.horizontal_swing)
             return;
-        this->on_horizontal_swing_change(value);
+        this->on_horizontal_swing_change(index);
     });
 }
 
@@ -279,9 +466,9 @@ void SinclairAC::set_display_select(select::Select *display_select)
 {
     this->display_select_ = display_select;
     this->display_select_->add_on_state_callback([this](const std::string &value, size_t index) {
-        if (value == this->display_state_)
+        if (index == this->settings_.display)
             return;
-        this->on_display_change(value);
+        this->on_display_change(index);
     });
 }
 
@@ -289,9 +476,9 @@ void SinclairAC::set_display_unit_select(select::Select *display_unit_select)
 {
     this->display_unit_select_ = display_unit_select;
     this->display_unit_select_->add_on_state_callback([this](const std::string &value, size_t index) {
-        if (value == this->display_unit_state_)
+        if (index == this->settings_.display_unit)
             return;
-        this->on_display_unit_change(value);
+        this->on_display_unit_change(index);
     });
 }
 
@@ -299,7 +486,7 @@ void SinclairAC::set_plasma_switch(switch_::Switch *plasma_switch)
 {
     this->plasma_switch_ = plasma_switch;
     this->plasma_switch_->add_on_state_callback([this](bool state) {
-        if (state == this->plasma_state_)
+        if (state == this->settings_.plasma)
             return;
         this->on_plasma_change(state);
     });
@@ -309,7 +496,7 @@ void SinclairAC::set_sleep_switch(switch_::Switch *sleep_switch)
 {
     this->sleep_switch_ = sleep_switch;
     this->sleep_switch_->add_on_state_callback([this](bool state) {
-        if (state == this->sleep_state_)
+        if (state == this->settings_.sleep)
             return;
         this->on_sleep_change(state);
     });
@@ -319,7 +506,7 @@ void SinclairAC::set_xfan_switch(switch_::Switch *xfan_switch)
 {
     this->xfan_switch_ = xfan_switch;
     this->xfan_switch_->add_on_state_callback([this](bool state) {
-        if (state == this->xfan_state_)
+        if (state == this->settings_.xfan)
             return;
         this->on_xfan_change(state);
     });
@@ -329,23 +516,175 @@ void SinclairAC::set_save_switch(switch_::Switch *save_switch)
 {
     this->save_switch_ = save_switch;
     this->save_switch_->add_on_state_callback([this](bool state) {
-        if (state == this->save_state_)
+        if (state == this->settings_.save)
             return;
         this->on_save_change(state);
     });
 }
 
+/*
+ * Link statistics
+ */
+
+void SinclairAC::set_statistics_sensor(StatisticsSensor statistic, sensor::Sensor *statistics_sensor)
+{
+    this->statistics_sensors_[(size_t) statistic] = statistics_sensor;
+    this->statistics_enabled_ = true;
+}
+
+void SinclairAC::set_statistics_interval(uint32_t interval)
+{
+    this->statistics_interval_ = interval;
+}
+
+void SinclairAC::publish_statistics()
+{
+    uint32_t now = this->clock_();
+    float elapsed = (now - this->statistics_published_) / 1000.0f;
+    this->statistics_published_ = now;
+
+    if (elapsed > 0)
+    {
+        this->publish_statistic(StatisticsSensor::RX_RATE, (this->link_stats_.rx_frames - this->statistics_rx_frames_) / elapsed);
+        this->publish_statistic(StatisticsSensor::TX_RATE, (this->link_stats_.tx_frames - this->statistics_tx_frames_) / elapsed);
+    }
+    this->statistics_rx_frames_ = this->link_stats_.rx_frames;
+    this->statistics_tx_frames_ = this->link_stats_.tx_frames;
+
+    this->publish_statistic(StatisticsSensor::CHECKSUM_ERRORS, this->link_stats_.checksum_errors);
+    this->publish_statistic(StatisticsSensor::LENGTH_ERRORS, this->link_stats_.length_errors);
+    this->publish_statistic(StatisticsSensor::RESYNCS, this->link_stats_.resyncs);
+    this->publish_statistic(StatisticsSensor::DROPPED_FRAMES, this->serialProcess_.dropped_cnt);
+    this->publish_statistic(StatisticsSensor::TIMEOUT_FRAMES, this->serialProcess_.timeout_cnt);
+    this->publish_statistic(StatisticsSensor::INACTIVE_TIMEOUTS, this->link_stats_.inactive_timeouts);
+    this->publish_statistic(StatisticsSensor::PUBLISHES_EMITTED, this->publishes_emitted_);
+    this->publish_statistic(StatisticsSensor::PUBLISHES_SUPPRESSED, this->publishes_suppressed_);
+
+    /* last completed resync, unknown until there is one - the one in progress is not counted */
+    uint32_t resyncs_done = this->link_stats_.resyncs - (this->resyncing_ ? 1 : 0);
+    this->publish_statistic(StatisticsSensor::RESYNC_LATENCY, resyncs_done ? (float) this->resync_latency_ : NAN);
+
+    /* average round trip since last publish, unknown if AC did not respond at all */
+    this->publish_statistic(StatisticsSensor::ROUND_TRIP_TIME,
+                            this->link_stats_.rtt_cnt ? (float) this->link_stats_.rtt_sum / this->link_stats_.rtt_cnt : NAN);
+    this->link_stats_.rtt_sum = 0;
+    this->link_stats_.rtt_cnt = 0;
+}
+
+void SinclairAC::publish_statistic(StatisticsSensor statistic, float value)
+{
+    sensor::Sensor *statistics_sensor = this->statistics_sensors_[(size_t) statistic];
+    if (statistics_sensor != nullptr)
+    {
+        statistics_sensor->publish_state(value);
+    }
+}
+
 /*
  * Debugging
  */
 
-void SinclairAC::log_packet(std::vector<uint8_t> data, bool outgoing)
+#ifdef USE_SINCLAIR_AC_PROFILER
+void SinclairAC::log_profile()
 {
+    for (size_t stage = 0; stage < (size_t) ProfileStage::COUNT; stage++)
+    {
+        StageProfile_t &profile = this->profile_[stage];
+        /* bucket bound is capped by the max, so the last open ended bucket reads as the max */
+        ESP_LOGI(TAG, "Loop profile %s: p50 <= %u us, p99 <= %u us, max %u us",
+                 PROFILE_STAGE_NAMES[stage],
+                 (unsigned) std::min(profile.histogram.percentile(50), profile.max),
+                 (unsigned) std::min(profile.histogram.percentile(99), profile.max),
+                 (unsigned) profile.max);
+        profile = {{profile.histogram.first_bound, {}}, 0};
+    }
+}
+#endif
+
+#ifdef USE_SINCLAIR_AC_CAPTURE
+static const char *const CAPTURE_KIND_NAMES[] = {
+    "RX",
+    "TX",
+    "RX checksum error",
+    "RX length error",
+};
+
+void SinclairAC::capture_packet(const uint8_t *data, size_t len, CaptureKind kind)
+{
+    if (this->capture_ == nullptr)
+    {
+        return;
+    }
+
+    /* only copy here - formatting is deferred to dump_capture() */
+    CaptureEntry_t &entry = this->capture_[this->capture_next_];
+    entry.time = this->clock_();
+    entry.len = std::min(len, (size_t) UINT8_MAX);
+    entry.kind = kind;
+    memcpy(entry.data, data, std::min(len, (size_t) CAPTURE_DATA_MAX));
+
+    this->capture_next_ = (this->capture_next_ + 1) % this->capture_frames_;
+    if (this->capture_cnt_ < this->capture_frames_)
+    {
+        this->capture_cnt_++;
+    }
+}
+
+const CaptureEntry_t *SinclairAC::get_capture(uint8_t idx) const
+{
+    if (idx >= this->capture_cnt_)
+    {
+        return nullptr;
+    }
+    return &this->capture_[(this->capture_next_ + this->capture_frames_ - this->capture_cnt_ + idx) % this->capture_frames_];
+}
+#endif
+
+void SinclairAC::dump_capture()
+{
+#ifdef USE_SINCLAIR_AC_CAPTURE
+    if (this->capture_ == nullptr)
+    {
+        ESP_LOGW(TAG, "Frame capture is not enabled");
+        return;
+    }
+
+    uint32_t now = this->clock_();
+    ESP_LOGI(TAG, "Capture dump: %u frames", (unsigned) this->capture_cnt_);
+    for (uint8_t i = 0; i < this->capture_cnt_; i++)
+    {
+        const CaptureEntry_t &entry = *this->get_capture(i);
+        ESP_LOGI(TAG, "%s t=%u (-%u ms) len=%u: %s",
+                 CAPTURE_KIND_NAMES[(size_t) entry.kind],
+                 (unsigned) entry.time,
+                 (unsigned) (now - entry.time),
+                 (unsigned) entry.len,
+                 format_hex_pretty(entry.data, std::min(entry.len, CAPTURE_DATA_MAX)).c_str());
+    }
+#else
+    ESP_LOGW(TAG, "Frame capture is not enabled");
+#endif
+}
+
+void SinclairAC::log_packet(const uint8_t *data, size_t len, bool outgoing)
+{
+#ifdef USE_SINCLAIR_AC_CAPTURE
+    this->capture_packet(data, len, outgoing ? CaptureKind::TX : CaptureKind::RX);
+#endif
+
+    /* format_hex_pretty() allocates even if ESP_LOGV discards the line - only build it when VERBOSE is compiled in
+       and the level set at runtime, for all tags or for this one, lets the line out */
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+#ifdef USE_LOGGER
+    if (logger::global_logger == nullptr || logger::global_logger->level_for(TAG) < ESPHOME_LOG_LEVEL_VERBOSE)
+        return;
+#endif
     if (outgoing) {
-        ESP_LOGV(TAG, "TX: %s", format_hex_pretty(data).c_str());
+        ESP_LOGV(TAG, "TX: %s", format_hex_pretty(data, len).c_str());
     } else {
-        ESP_LOGV(TAG, "RX: %s", format_hex_pretty(data).c_str());
+        ESP_LOGV(TAG, "RX: %s", format_hex_pretty(data, len).c_str());
     }
+#endif
 }
 
 }  // namespace sinclair_ac
@@ -7,6 +7,13 @@
 #include "esphome/components/switch/switch.h"
 #include "esphome/components/uart/uart.h"
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+
+#include "esppac_core.h"
+
+#ifdef USE_SINCLAIR_AC_CAPTURE
+#include <memory>
+#endif
 
 namespace esphome {
 
@@ -15,6 +22,7 @@ namespace sinclair_ac {
 static const char *const VERSION = "0.0.1";
 
 static const uint8_t READ_TIMEOUT = 20;  // The maximum time to wait before considering a packet complete
+static const uint8_t RX_CHUNK_MAX = 64;  // Number of bytes fetched from UART at once
 
 static const uint8_t MIN_TEMPERATURE = 16;   // Minimum temperature as reported by EWPE SMART APP
 static const uint8_t MAX_TEMPERATURE = 30;   // Maximum temperature as supported by EWPE SMART APP
@@ -22,74 +30,167 @@ static const float TEMPERATURE_STEP = 1.0;   // Steps the temperature can be set
 static const float TEMPERATURE_TOLERANCE = 2;  // The tolerance to allow when checking the climate state
 static const uint8_t TEMPERATURE_THRESHOLD = 100;  // Maximum temperature the AC can report (formally 119.5 for sinclair protocol, but 100 is impossible, soo...)
 
-namespace fan_modes{
-    const std::string FAN_AUTO  = "0 - Auto";
-    const std::string FAN_QUIET = "1 - Quiet";
-    const std::string FAN_LOW   = "2 - Low";
-    const std::string FAN_MEDL  = "3 - Medium-Low";
-    const std::string FAN_MED   = "4 - Medium";
-    const std::string FAN_MEDH  = "5 - Medium-High";
-    const std::string FAN_HIGH  = "6 - High";
-    const std::string FAN_TURBO = "7 - Turbo";
+/* Settings decoded from AC report - a bit is set in dirty mask when the value differs from the stored one */
+namespace report_fields{
+    enum : uint16_t {
+        MODE                = 1 << 0,
+        FAN_MODE            = 1 << 1,
+        TARGET_TEMPERATURE  = 1 << 2,
+        CURRENT_TEMPERATURE = 1 << 3,
+        SWING_MODE          = 1 << 4,
+        VERTICAL_SWING      = 1 << 5,
+        HORIZONTAL_SWING    = 1 << 6,
+        DISPLAY             = 1 << 7,
+        DISPLAY_UNIT        = 1 << 8,
+        PLASMA              = 1 << 9,
+        SLEEP               = 1 << 10,
+        XFAN                = 1 << 11,
+        SAVE                = 1 << 12,
+
+        CLIMATE             = MODE | FAN_MODE | TARGET_TEMPERATURE | CURRENT_TEMPERATURE | SWING_MODE,
+        ALL                 = (1 << 13) - 1
+    };
 }
 
-/* this must be same as HORIZONTAL_SWING_OPTIONS in climate.py */
-namespace horizontal_swing_options{
-    const std::string OFF    = "0 - OFF";
-    const std::string FULL   = "1 - Swing - Full";
-    const std::string CLEFT  = "2 - Constant - Left";
-    const std::string CMIDL  = "3 - Constant - Mid-Left";
-    const std::string CMID   = "4 - Constant - Middle";
-    const std::string CMIDR  = "5 - Constant - Mid-Right";
-    const std::string CRIGHT = "6 - Constant - Right";
-}
+/* Histogram of durations with power of two bucket bounds - bucket i counts values below first_bound << i,
+   the last bucket counts the rest */
+struct Histogram {
+        static const uint8_t BUCKETS = 8;
+
+        uint32_t first_bound;
+        uint32_t count[BUCKETS];
+
+        void add(uint32_t value)
+        {
+            uint8_t idx = 0;
+            for (uint32_t bound = this->first_bound; idx < BUCKETS - 1 && value >= bound; bound <<= 1)
+            {
+                idx++;
+            }
+            this->count[idx]++;
+        }
+
+        /* upper bound of the bucket holding given percentile of values, 0 - no values */
+        uint32_t percentile(uint8_t percent) const
+        {
+            uint32_t total = 0;
+            for (uint32_t cnt : this->count)
+            {
+                total += cnt;
+            }
+            uint32_t target = (total * percent + 99) / 100;
+            uint32_t seen = 0;
+            for (uint8_t idx = 0; idx < BUCKETS && total > 0; idx++)
+            {
+                seen += this->count[idx];
+                if (seen >= target)
+                {
+                    return idx < BUCKETS - 1 ? this->first_bound << idx : UINT32_MAX;
+                }
+            }
+            return 0;
+        }
+};
 
-/* this must be same as VERTICAL_SWING_OPTIONS in climate.py */
-namespace vertical_swing_options{
-    const std::string OFF   = "00 - OFF";
-    const std::string FULL  = "01 - Swing - Full";
-    const std::string DOWN  = "02 - Swing - Down";
-    const std::string MIDD  = "03 - Swing - Mid-Down";
-    const std::string MID   = "04 - Swing - Middle";
-    const std::string MIDU  = "05 - Swing - Mid-Up";
-    const std::string UP    = "06 - Swing - Up";
-    const std::string CDOWN = "07 - Constant - Down";
-    const std::string CMIDD = "08 - Constant - Mid-Down";
-    const std::string CMID  = "09 - Constant - Middle";
-    const std::string CMIDU = "10 - Constant - Mid-Up";
-    const std::string CUP   = "11 - Constant - Up";
-}
+#ifdef USE_SINCLAIR_AC_PROFILER
+/* Stages of loop() timed by the profiler */
+enum class ProfileStage : uint8_t {
+        READ_DATA,
+        HANDLE_PACKET,
+        SEND_PACKET,
+        COUNT
+};
 
-/* this must be same as DISPLAY_OPTIONS in climate.py */
-namespace display_options{
-    const std::string OFF  = "0 - OFF";
-    const std::string AUTO = "1 - Auto";
-    const std::string SET  = "2 - Set temperature";
-    const std::string ACT  = "3 - Actual temperature";
-    const std::string OUT  = "4 - Outside temperature";
-}
+static const char *const PROFILE_STAGE_NAMES[(size_t) ProfileStage::COUNT] = {
+        "read_data",
+        "handle_packet",
+        "send_packet",
+};
 
-/* this must be same as DISPLAY_UNIT_OPTIONS in climate.py */
-namespace display_unit_options{
-    const std::string DEGC = "C";
-    const std::string DEGF = "F";
-}
+static const uint32_t PROFILE_LOG_INTERVAL = 60000;  /* ms between profile log lines */
+
+typedef struct {
+        Histogram histogram;  /* us */
+        uint32_t max;         /* us */
+} StageProfile_t;
+
+/* Times the enclosing scope into given stage profile */
+class ProfileScope {
+    public:
+        explicit ProfileScope(StageProfile_t &profile) : profile_(profile), start_(micros()) {}
+        ~ProfileScope()
+        {
+            uint32_t duration = micros() - this->start_;
+            this->profile_.histogram.add(duration);
+            this->profile_.max = std::max(this->profile_.max, duration);
+        }
+
+    protected:
+        StageProfile_t &profile_;
+        uint32_t start_;
+};
 
-typedef enum {
-        STATE_WAIT_SYNC,
-        STATE_RECIEVE,
-        STATE_COMPLETE,
-        STATE_RESTART
-} SerialProcessState_t;
+#define SINCLAIR_AC_PROFILE(stage) ProfileScope profile_scope_(this->profile_[(size_t) (stage)])
+#else
+#define SINCLAIR_AC_PROFILE(stage)
+#endif
 
-static const uint8_t DATA_MAX = 200;
+#ifdef USE_SINCLAIR_AC_CAPTURE
+static const uint8_t CAPTURE_DATA_MAX = 72;  /* longest frame we expect, longer ones are stored truncated */
+
+enum class CaptureKind : uint8_t {
+        RX,
+        TX,
+        RX_CHECKSUM_ERROR,  /* whole frame, checksum does not match */
+        RX_LENGTH_ERROR,    /* start of a frame only, LEN does not fit the buffer or the command */
+};
 
 typedef struct {
-        std::vector<uint8_t> data;
-        uint8_t data_cnt;
-        uint8_t frame_size;
-        SerialProcessState_t state;
-} SerialProcess_t;
+        uint32_t time;                    /* clock_() at capture */
+        uint8_t len;                      /* original frame length, may exceed CAPTURE_DATA_MAX */
+        CaptureKind kind;
+        uint8_t data[CAPTURE_DATA_MAX];
+} CaptureEntry_t;
+#endif
+
+/* Link health counters, see SinclairAC::publish_statistics() */
+typedef struct {
+        uint32_t rx_frames;          /* frames with valid checksum */
+        uint32_t tx_frames;
+        uint32_t checksum_errors;
+        uint32_t length_errors;      /* LEN byte not fitting DATA_MAX or not matching the command */
+        uint32_t resyncs;            /* times the frame sync was lost */
+        uint32_t inactive_timeouts;  /* times AC stopped responding and the component went Initializing */
+        uint32_t rtt_sum;            /* ms from TX to the next recieved frame, summed since last publish */
+        uint32_t rtt_cnt;
+} LinkStats_t;
+
+/* this must be same as STATISTICS_SENSORS in climate.py */
+enum class StatisticsSensor : uint8_t {
+        RX_RATE,
+        TX_RATE,
+        CHECKSUM_ERRORS,
+        LENGTH_ERRORS,
+        RESYNCS,
+        DROPPED_FRAMES,
+        TIMEOUT_FRAMES,
+        INACTIVE_TIMEOUTS,
+        ROUND_TRIP_TIME,
+        TX_LATENCY_P50,
+        TX_LATENCY_P99,
+        RESYNC_LATENCY,
+        UNKNOWN_PACKETS,
+        IDENTICAL_REPORTS,
+        PUBLISHES_EMITTED,
+        PUBLISHES_SUPPRESSED,
+        COALESCED_CHANGES,
+        UPDATE_RETRIES,
+        FAILED_UPDATES,
+        COUNT
+};
+
+/* Source of milliseconds for all protocol timing, see SinclairAC::set_clock() */
+typedef uint32_t (*Clock_t)();
 
 class SinclairAC : public Component, public uart::UARTDevice, public climate::Climate {
     public:
@@ -106,9 +207,35 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
 
         void set_current_temperature_sensor(sensor::Sensor *current_temperature_sensor);
 
+        void set_statistics_sensor(StatisticsSensor statistic, sensor::Sensor *statistics_sensor);
+        void set_statistics_interval(uint32_t interval);
+
+        /* lets the protocol run under simulated time on a host, must be set before setup() */
+        void set_clock(Clock_t clock) { this->clock_ = clock; }
+
+#ifdef USE_SINCLAIR_AC_CAPTURE
+        /* number of last frames kept for dump_capture(), 0 leaves capture of this instance off, set before setup() */
+        void set_capture_frames(uint8_t frames) { this->capture_frames_ = frames; }
+        /* captured entry, oldest first, nullptr past the last one */
+        const CaptureEntry_t *get_capture(uint8_t idx) const;
+#endif
+        /* logs captured frames, oldest first */
+        void dump_capture();
+
+        /* feeds logged hex bytes through framing and decoding as if they were recieved from AC,
+           link statistics and state are left as they are */
+        void replay_packet(const std::string &hex);
+
         void setup() override;
         void loop() override;
 
+        uint32_t get_dropped_frames() const { return this->serialProcess_.dropped_cnt; }
+        uint32_t get_timeout_frames() const { return this->serialProcess_.timeout_cnt; }
+        uint32_t get_resync_latency() const { return this->resync_latency_; }
+        uint32_t get_publishes_emitted() const { return this->publishes_emitted_; }
+        uint32_t get_publishes_suppressed() const { return this->publishes_suppressed_; }
+        const LinkStats_t &get_link_stats() const { return this->link_stats_; }
+
     protected:
         select::Select *vertical_swing_select_   = nullptr; /* Advanced vertical swing select */
         select::Select *horizontal_swing_select_ = nullptr; /* Advanced horizontal swing select */
@@ -123,57 +250,109 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
 
         sensor::Sensor *current_temperature_sensor_ = nullptr; /* If user wants to replace reported temperature by an external sensor readout */
 
-        std::string vertical_swing_state_;
-        std::string horizontal_swing_state_;
+        /* until first report comes this encodes as AUTO fan, swings OFF and display AUTO */
+        ACSettings_t settings_ = {fan_modes::FAN_AUTO, vertical_swing_options::OFF, horizontal_swing_options::OFF,
+                                  display_options::AUTO, display_options::AUTO, display_unit_options::DEGC,
+                                  false, false, false, false};
 
-        std::string display_state_;
-        std::string display_unit_state_;
+        uint16_t pending_publish_ = report_fields::ALL;  /* report_fields changed locally, published with next report */
+        uint16_t rejected_changes_ = 0;  /* report_fields of selects and switches changed while AC was not ready */
+        uint32_t publishes_emitted_ = 0;     /* entity state publishes done */
+        uint32_t publishes_suppressed_ = 0;  /* entity state publishes skipped as the state did not change */
 
-        bool plasma_state_;
-        bool sleep_state_;
-        bool xfan_state_;
-        bool save_state_;
+        SerialProcess_t serialProcess_ = {};
 
-        SerialProcess_t serialProcess_;
+        uint8_t rx_chunk_[RX_CHUNK_MAX];  /* bytes fetched from UART but not yet parsed */
+        uint8_t rx_chunk_len_ = 0;
+        uint8_t rx_chunk_pos_ = 0;
 
+        Clock_t clock_ = &millis;  // Time source of the protocol timing, see set_clock()
         uint32_t init_time_;   // Stores the current time
-        // uint32_t last_read_;   // Stores the time at which the last read was done
+        uint32_t last_read_;   // Stores the time at which the last read was done
         uint32_t last_packet_sent_;  // Stores the time at which the last packet was sent
         uint32_t last_packet_received_;  // Stores the time at which the last packet was received
-        bool wait_response_;
+        bool wait_response_ = false;
+
+        bool resyncing_ = false;      // Set when a frame was dropped and no valid frame came since
+        uint32_t resync_start_;       // Stores the time at which the first frame was dropped
+        uint32_t resync_latency_ = 0; // Time it took to recieve a valid frame after the last drop
+
+        LinkStats_t link_stats_ = {};
+        sensor::Sensor *statistics_sensors_[(size_t) StatisticsSensor::COUNT] = {}; /* Optional link statistics sensors */
+        bool statistics_enabled_ = false;       // Set when any statistics sensor is configured
+        uint32_t statistics_interval_ = 60000;  // Period of publishing statistics sensors
+        uint32_t statistics_published_;         // Stores the time at which statistics were last published
+        uint32_t statistics_rx_frames_ = 0;     // rx_frames at last publish, for the rate
+        uint32_t statistics_tx_frames_ = 0;     // tx_frames at last publish, for the rate
+
+#ifdef USE_SINCLAIR_AC_PROFILER
+        StageProfile_t profile_[(size_t) ProfileStage::COUNT];
+#endif
+
+#ifdef USE_SINCLAIR_AC_CAPTURE
+        std::unique_ptr<CaptureEntry_t[]> capture_;  // capture_frames_ entries, allocated by setup()
+        uint8_t capture_frames_ = 0;  // size of capture_, 0 when capture is off
+        uint8_t capture_next_ = 0;    // slot overwritten by the next captured frame
+        uint8_t capture_cnt_ = 0;     // number of valid entries, up to capture_frames_
+#endif
 
         climate::ClimateTraits traits() override;
 
         void read_data();
+        size_t parse_data(const uint8_t *data, size_t len);
+        static bool check_header(void *ctx, uint8_t len, uint8_t cmd);  /* HeaderCheck_t forwarding to is_valid_header() */
+        void mark_resync();
 
-        void update_current_temperature(float temperature);
-        void update_target_temperature(float temperature);
+        bool update_current_temperature(float temperature);
+        bool update_target_temperature(float temperature);
 
-        void update_swing_horizontal(const std::string &swing);
-        void update_swing_vertical(const std::string &swing);
+        bool update_swing_horizontal(uint8_t swing);
+        bool update_swing_vertical(uint8_t swing);
 
-        void update_display(const std::string &display);
-        void update_display_unit(const std::string &display_unit);
+        bool update_display(uint8_t display);
+        bool update_display_unit(uint8_t display_unit);
 
-        void update_plasma(bool plasma);
-        void update_sleep(bool sleep);
-        void update_xfan(bool xfan);
-        void update_save(bool save);
+        bool update_plasma(bool plasma);
+        bool update_sleep(bool sleep);
+        bool update_xfan(bool xfan);
+        bool update_save(bool save);
 
-        virtual void on_horizontal_swing_change(const std::string &swing) = 0;
-        virtual void on_vertical_swing_change(const std::string &swing) = 0;
+        void publish_changes(uint16_t dirty);
+        void publish_settings(uint16_t dirty);
+        void publish_select(select::Select *select, bool changed, const char *option);
+        void publish_switch(switch_::Switch *sw, bool changed, bool state);
+        void reject_change(uint16_t field);
+        void publish_rejected();
 
-        virtual void on_display_change(const std::string &display) = 0;
-        virtual void on_display_unit_change(const std::string &display_unit) = 0;
+        virtual void on_horizontal_swing_change(uint8_t swing) = 0;
+        virtual void on_vertical_swing_change(uint8_t swing) = 0;
+
+        virtual void on_display_change(uint8_t display) = 0;
+        virtual void on_display_unit_change(uint8_t display_unit) = 0;
 
         virtual void on_plasma_change(bool plasma) = 0;
         virtual void on_sleep_change(bool sleep) = 0;
         virtual void on_xfan_change(bool xfan) = 0;
         virtual void on_save_change(bool save) = 0;
 
+        virtual bool is_valid_header(uint8_t len, uint8_t cmd) = 0;
+        /* handles a complete frame of replay_packet(), bypassing link state */
+        virtual void replay_frame(const FrameView &frame) = 0;
+
         climate::ClimateAction determine_action();
 
-        void log_packet(std::vector<uint8_t> data, bool outgoing = false);
+        virtual void publish_statistics();
+        void publish_statistic(StatisticsSensor statistic, float value);
+
+#ifdef USE_SINCLAIR_AC_PROFILER
+        void log_profile();
+#endif
+
+#ifdef USE_SINCLAIR_AC_CAPTURE
+        void capture_packet(const uint8_t *data, size_t len, CaptureKind kind);
+#endif
+
+        void log_packet(const uint8_t *data, size_t len, bool outgoing = false);
 };
 
 }  // namespace sinclair_ac
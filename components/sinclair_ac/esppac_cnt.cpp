@@ -7,10 +7,32 @@ namespace CNT {
 
 static const char *const TAG = "sinclair_ac.serial";
 
+/* Climate mode to REPORT_MODE_*, OPTION_INVALID for modes AC does not have (including OFF) */
+static uint8_t report_mode(climate::ClimateMode mode)
+{
+    switch (mode)
+    {
+        case climate::CLIMATE_MODE_AUTO:
+            return protocol::REPORT_MODE_AUTO;
+        case climate::CLIMATE_MODE_COOL:
+            return protocol::REPORT_MODE_COOL;
+        case climate::CLIMATE_MODE_DRY:
+            return protocol::REPORT_MODE_DRY;
+        case climate::CLIMATE_MODE_FAN_ONLY:
+            return protocol::REPORT_MODE_FAN;
+        case climate::CLIMATE_MODE_HEAT:
+            return protocol::REPORT_MODE_HEAT;
+        default:
+            return OPTION_INVALID;
+    }
+}
+
 void SinclairACCNT::setup()
 {
     SinclairAC::setup();
 
+    this->set_frame_.init();
+
     ESP_LOGD(TAG, "Using serial protocol for Sinclair AC");
 }
 
@@ -20,48 +42,67 @@ void SinclairACCNT::loop()
     SinclairAC::loop();
 
     /* we have a frame from AC */
-    if (this->serialProcess_.state == STATE_COMPLETE)
+    if (this->serialProcess_.pending != nullptr)
     {
-        /* do not forget to order for restart of the recieve state machine */
-        this->serialProcess_.state = STATE_RESTART;
+        FrameView frame = {this->serialProcess_.pending->data, this->serialProcess_.pending->data_cnt};
         /* mark that we have recieved a response */
+        if (this->wait_response_)
+        {
+            this->link_stats_.rtt_sum += this->clock_() - this->last_packet_sent_;
+            this->link_stats_.rtt_cnt++;
+        }
         this->wait_response_ = false;
         /* log for ESPHome debug */
-        log_packet(this->serialProcess_.data);
+        log_packet(frame.data, frame.len);
 
-        if (!verify_packet())  /* Verify length, header, counter and checksum */
+        bool valid = verify_packet(frame);  /* Verify length, header, counter and checksum */
+        if (valid)
         {
-            return;
-        }
+            this->last_packet_received_ = this->clock_();  /* Set the time at which we received our last packet */
 
-        this->last_packet_received_ = millis();  /* Set the time at which we received our last packet */
+            /* A valid recieved packet of accepted type marks module as being ready */
+            if (this->state_ != ACState::Ready)
+            {
+                this->state_ = ACState::Ready;  
+                Component::status_clear_error();
+                this->last_packet_sent_ = this->clock_();
+                this->init_refresh_interval_ = this->fast_refresh_interval_;
+            }
 
-        /* A valid recieved packet of accepted type marks module as being ready */
-        if (this->state_ != ACState::Ready)
-        {
-            this->state_ = ACState::Ready;  
-            Component::status_clear_error();
-            this->last_packet_sent_ = millis();
+            if (this->update_ == ACUpdate::NoUpdate)
+            {
+                SINCLAIR_AC_PROFILE(ProfileStage::HANDLE_PACKET);
+                handle_packet(frame); /* this will update state of components in HA as well as internal settings */
+            }
         }
 
-        if (this->update_ == ACUpdate::NoUpdate)
+        /* do not forget to release the slot back to the recieve state machine */
+        this->serialProcess_.pending = nullptr;
+
+        if (!valid)
         {
-            handle_packet(); /* this will update state of components in HA as well as internal settings */
+            return;
         }
     }
 
     /* we will send a packet to the AC as a reponse to indicate changes */
-    send_packet();
+    {
+        SINCLAIR_AC_PROFILE(ProfileStage::SEND_PACKET);
+        send_packet();
+    }
 
-    /* if there are no packets for 5 seconds - mark module as not ready */
-    if (millis() - this->last_packet_received_ >= protocol::TIME_TIMEOUT_INACTIVE_MS)
+    /* if there are no packets for a while - mark module as not ready */
+    if (this->clock_() - this->last_packet_received_ >= this->inactive_timeout())
     {
         if (this->state_ != ACState::Initializing)
         {
             this->state_ = ACState::Initializing;
             Component::status_set_error();
+            this->link_stats_.inactive_timeouts++;
         }
     }
+
+    this->publish_rejected();
 }
 
 /*
@@ -76,14 +117,16 @@ void SinclairACCNT::control(const climate::ClimateCall &call)
     if (call.get_mode().has_value())
     {
         ESP_LOGV(TAG, "Requested mode change");
-        this->update_ = ACUpdate::UpdateStart;
+        this->request_update();
+        this->pending_publish_ |= report_fields::MODE;
         this->mode = *call.get_mode();
     }
 
     if (call.get_target_temperature().has_value())
     {
         ESP_LOGV(TAG, "Requested target teperature change");
-        this->update_ = ACUpdate::UpdateStart;
+        this->request_update();
+        this->pending_publish_ |= report_fields::TARGET_TEMPERATURE;
         this->target_temperature = *call.get_target_temperature();
         if (this->target_temperature < MIN_TEMPERATURE)
         {
@@ -98,426 +141,388 @@ void SinclairACCNT::control(const climate::ClimateCall &call)
     if (call.get_custom_fan_mode().has_value())
     {
         ESP_LOGV(TAG, "Requested fan mode change");
-        this->update_ = ACUpdate::UpdateStart;
+        this->request_update();
+        this->pending_publish_ |= report_fields::FAN_MODE;
         this->custom_fan_mode = *call.get_custom_fan_mode();
+        this->settings_.fan_mode = find_option(fan_modes::NAMES, *this->custom_fan_mode, fan_modes::FAN_AUTO);
     }
 
     if (call.get_swing_mode().has_value())
     {
         ESP_LOGV(TAG, "Requested swing mode change");
-        this->update_ = ACUpdate::UpdateStart;
+        this->request_update();
+        /* swing selects follow swing mode of climate */
+        this->pending_publish_ |= report_fields::SWING_MODE | report_fields::VERTICAL_SWING | report_fields::HORIZONTAL_SWING;
         switch (*call.get_swing_mode()) {
             case climate::CLIMATE_SWING_BOTH:
-                this->vertical_swing_state_   =   vertical_swing_options::FULL;
-                this->horizontal_swing_state_ = horizontal_swing_options::FULL;
+                this->settings_.vertical_swing   =   vertical_swing_options::FULL;
+                this->settings_.horizontal_swing = horizontal_swing_options::FULL;
                 break;
             case climate::CLIMATE_SWING_OFF:
                 /* both center */
-                this->vertical_swing_state_   =   vertical_swing_options::CMID;
-                this->horizontal_swing_state_ = horizontal_swing_options::CMID;
+                this->settings_.vertical_swing   =   vertical_swing_options::CMID;
+                this->settings_.horizontal_swing = horizontal_swing_options::CMID;
                 break;
             case climate::CLIMATE_SWING_VERTICAL:
                 /* vertical full, horizontal center */
-                this->vertical_swing_state_   =   vertical_swing_options::FULL;
-                this->horizontal_swing_state_ = horizontal_swing_options::CMID;
+                this->settings_.vertical_swing   =   vertical_swing_options::FULL;
+                this->settings_.horizontal_swing = horizontal_swing_options::CMID;
                 break;
             case climate::CLIMATE_SWING_HORIZONTAL:
                 /* horizontal full, vertical center */
-                this->vertical_swing_state_   =   vertical_swing_options::CMID;
-                this->horizontal_swing_state_ = horizontal_swing_options::FULL;
+                this->settings_.vertical_swing   =   vertical_swing_options::CMID;
+                this->settings_.horizontal_swing = horizontal_swing_options::FULL;
                 break;
             default:
                 ESP_LOGV(TAG, "Unsupported swing mode requested");
                 /* both center */
-                this->vertical_swing_state_   =   vertical_swing_options::CMID;
-                this->horizontal_swing_state_ = horizontal_swing_options::CMID;
+                this->settings_.vertical_swing   =   vertical_swing_options::CMID;
+                this->settings_.horizontal_swing = horizontal_swing_options::CMID;
                 break;
         }
     }
 }
 
 /*
- * Send a raw packet, as is
+ * Mark that settings were changed locally and need to be sent to AC
  */
-void SinclairACCNT::send_packet()
+void SinclairACCNT::request_update()
 {
-    std::vector<uint8_t> packet(protocol::SET_PACKET_LEN, 0);  /* Initialize packet contents */
-
-    if (this->wait_response_ == true && (millis() - this->last_packet_sent_) < protocol::TIME_REFRESH_PERIOD_MS)
+    if (this->update_ == ACUpdate::UpdatePending || this->update_ == ACUpdate::UpdateStart)
     {
-        /* do net send packet too often or when we are waiting for report to come */
+        /* update was not sent yet - it will carry this change as well */
+        this->coalesced_changes_++;
         return;
     }
-    
-    packet[protocol::SET_CONST_02_BYTE] = protocol::SET_CONST_02_VAL; /* Some always 0x02 byte... */
-    packet[protocol::SET_CONST_BIT_BYTE] = protocol::SET_CONST_BIT_MASK; /* Some always true bit */
 
-    /* Prepare the rest of the frame */
-    /* this handles tricky part of 0xAF value and flag marking that WiFi does not apply any changes */
-    switch(this->update_)
+    if (!this->confirm_pending_)
     {
-        default:
-        case ACUpdate::NoUpdate:
-            packet[protocol::SET_NOCHANGE_BYTE] |= protocol::SET_NOCHANGE_MASK;
-            break;
-        case ACUpdate::UpdateStart:
-            packet[protocol::SET_AF_BYTE] = protocol::SET_AF_VAL;
-            break;
-        case ACUpdate::UpdateClear:
-            break;
+        this->command_start_ = this->clock_();
     }
+    this->update_retries_ = 0;
 
-    /* MODE and POWER --------------------------------------------------------------------------- */
-    uint8_t mode = protocol::REPORT_MODE_AUTO;
-    bool power = false;
-    switch (this->mode)
-    {
-        case climate::CLIMATE_MODE_AUTO:
-            mode = protocol::REPORT_MODE_AUTO;
-            power = true;
-            break;
-        case climate::CLIMATE_MODE_COOL:
-            mode = protocol::REPORT_MODE_COOL;
-            power = true;
-            break;
-        case climate::CLIMATE_MODE_DRY:
-            mode = protocol::REPORT_MODE_DRY;
-            power = true;
-            break;
-        case climate::CLIMATE_MODE_FAN_ONLY:
-            mode = protocol::REPORT_MODE_FAN;
-            power = true;
-            break;
-        case climate::CLIMATE_MODE_HEAT:
-            mode = protocol::REPORT_MODE_HEAT;
-            power = true;
-            break;
-        default:
-        case climate::CLIMATE_MODE_OFF:
-            /* In case of MODE_OFF we will not alter the last mode setting recieved from AC, see determine_mode() */
-            switch (this->mode_internal_)
-            {
-                case climate::CLIMATE_MODE_AUTO:
-                    mode = protocol::REPORT_MODE_AUTO;
-                    break;
-                case climate::CLIMATE_MODE_COOL:
-                    mode = protocol::REPORT_MODE_COOL;
-                    break;
-                case climate::CLIMATE_MODE_DRY:
-                    mode = protocol::REPORT_MODE_DRY;
-                    break;
-                case climate::CLIMATE_MODE_FAN_ONLY:
-                    mode = protocol::REPORT_MODE_FAN;
-                    break;
-                case climate::CLIMATE_MODE_HEAT:
-                    mode = protocol::REPORT_MODE_HEAT;
-                    break;
-            }
-            power = false;
-            break;
-    }
+    this->update_ = ACUpdate::UpdatePending;
+    this->update_requested_ = this->clock_();
+    this->update_delay_ = this->update_coalesce_window_;
+}
 
-    packet[protocol::REPORT_MODE_BYTE] |= (mode << protocol::REPORT_MODE_POS);
-    if (power)
-    {
-        packet[protocol::REPORT_PWR_BYTE] |= protocol::REPORT_PWR_MASK;
-    }
+/*
+ * Check if settings reported by AC are the ones sent with the last update
+ */
+bool SinclairACCNT::desired_applied()
+{
+    const ACSettings_t &want = this->desired_.settings;
+
+    /* display_mode is not compared - it is the mode AC keeps while display is OFF */
+    return this->mode == this->desired_.mode &&
+           (uint8_t) this->target_temperature == (uint8_t) this->desired_.target_temperature &&
+           this->settings_.fan_mode == want.fan_mode &&
+           this->settings_.vertical_swing == want.vertical_swing &&
+           this->settings_.horizontal_swing == want.horizontal_swing &&
+           this->settings_.display == want.display &&
+           this->settings_.display_unit == want.display_unit &&
+           this->settings_.plasma == want.plasma &&
+           this->settings_.sleep == want.sleep &&
+           this->settings_.xfan == want.xfan &&
+           this->settings_.save == want.save;
+}
 
-    /* TARGET TEMPERATURE --------------------------------------------------------------------------- */
-    uint8_t target_temperature = ((((uint8_t)this->target_temperature) - protocol::REPORT_TEMP_SET_OFF) << protocol::REPORT_TEMP_SET_POS);
-    packet[protocol::REPORT_TEMP_SET_BYTE] |= (target_temperature & protocol::REPORT_TEMP_SET_MASK);
+/*
+ * Reconcile the first report after an update with what was requested, if AC did not apply the update
+ * the requested settings are restored and sent again with backoff. Returns false when retrying.
+ */
+bool SinclairACCNT::confirm_update()
+{
+    if (!this->confirm_pending_)
+        return true;
+
+    if (this->desired_applied())
+    {
+        uint32_t latency = this->clock_() - this->command_start_;
+        ESP_LOGD(TAG, "Update applied in %u ms, %u retries", (unsigned) latency, (unsigned) this->update_retries_);
+        this->confirm_pending_ = false;
+        if (this->apply_latency_sensor_ != nullptr)
+            this->apply_latency_sensor_->publish_state(latency);
+        if (this->apply_retries_sensor_ != nullptr)
+            this->apply_retries_sensor_->publish_state(this->update_retries_);
+        return true;
+    }
+
+    if (this->update_retries_ >= protocol::UPDATE_RETRIES_MAX)
+    {
+        /* give up - state reported by AC wins */
+        ESP_LOGW(TAG, "Update not applied by AC after %u retries", (unsigned) this->update_retries_);
+        this->confirm_pending_ = false;
+        this->failed_updates_++;
+        if (this->apply_retries_sensor_ != nullptr)
+            this->apply_retries_sensor_->publish_state(this->update_retries_);
+        return true;
+    }
+
+    this->update_retries_++;
+    this->update_retries_total_++;
+    ESP_LOGD(TAG, "Update not applied by AC, retry %u", (unsigned) this->update_retries_);
+
+    /* bring requested settings back, keeping display mode reported by AC */
+    uint8_t display_mode = this->settings_.display_mode;
+    this->mode = this->desired_.mode;
+    this->target_temperature = this->desired_.target_temperature;
+    this->settings_ = this->desired_.settings;
+    this->settings_.display_mode = display_mode;
+    this->custom_fan_mode = fan_modes::NAMES[this->settings_.fan_mode];
+
+    this->update_ = ACUpdate::UpdatePending;
+    this->update_requested_ = this->clock_();
+    this->update_delay_ = protocol::TIME_RETRY_BACKOFF_MS << (this->update_retries_ - 1);
+    return false;
+}
 
-    /* FAN SPEED --------------------------------------------------------------------------- */
-    /* below will default to AUTO */
-    uint8_t fanSpeed1 = 0;
-    uint8_t fanSpeed2 = 0;
-    bool    fanQuiet  = false;
-    bool    fanTurbo  = false;
+void SinclairACCNT::set_apply_latency_sensor(sensor::Sensor *apply_latency_sensor)
+{
+    this->apply_latency_sensor_ = apply_latency_sensor;
+}
 
-    if (this->custom_fan_mode == fan_modes::FAN_AUTO)
-    {
-        fanSpeed1 = 0;
-        fanSpeed2 = 0;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
-    else if (this->custom_fan_mode == fan_modes::FAN_LOW)
-    {
-        fanSpeed1 = 1;
-        fanSpeed2 = 1;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
-    else if (this->custom_fan_mode == fan_modes::FAN_QUIET)
-    {
-        fanSpeed1 = 1;
-        fanSpeed2 = 1;
-        fanQuiet  = true;
-        fanTurbo  = false;
-    }
-    else if (this->custom_fan_mode == fan_modes::FAN_MEDL)
-    {
-        fanSpeed1 = 2;
-        fanSpeed2 = 2;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
-    else if (this->custom_fan_mode == fan_modes::FAN_MED)
-    {
-        fanSpeed1 = 3;
-        fanSpeed2 = 2;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
-    else if (this->custom_fan_mode == fan_modes::FAN_MEDH)
-    {
-        fanSpeed1 = 4;
-        fanSpeed2 = 3;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
-    else if (this->custom_fan_mode == fan_modes::FAN_HIGH)
-    {
-        fanSpeed1 = 5;
-        fanSpeed2 = 3;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
-    else if (this->custom_fan_mode == fan_modes::FAN_TURBO)
-    {
-        fanSpeed1 = 5;
-        fanSpeed2 = 3;
-        fanQuiet  = false;
-        fanTurbo  = true;
-    }
-    else
-    {
-        fanSpeed1 = 0;
-        fanSpeed2 = 0;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
+void SinclairACCNT::set_apply_retries_sensor(sensor::Sensor *apply_retries_sensor)
+{
+    this->apply_retries_sensor_ = apply_retries_sensor;
+}
 
-    packet[protocol::REPORT_FAN_SPD1_BYTE] |= (fanSpeed1 << protocol::REPORT_FAN_SPD1_POS);
-    packet[protocol::REPORT_FAN_SPD2_BYTE] |= (fanSpeed2 << protocol::REPORT_FAN_SPD2_POS);
-    if (fanTurbo)
-    {
-        packet[protocol::REPORT_FAN_TURBO_BYTE] |= protocol::REPORT_FAN_TURBO_MASK;
-    }
-    if (fanQuiet)
-    {
-        packet[protocol::REPORT_FAN_QUIET_BYTE] |= protocol::REPORT_FAN_QUIET_MASK;
-    }
+/*
+ * Link statistics, protocol counters and how long changes waited for their update to go out
+ */
+void SinclairACCNT::publish_statistics()
+{
+    SinclairAC::publish_statistics();
 
-    /* VERTICAL SWING --------------------------------------------------------------------------- */
-    uint8_t mode_vertical_swing = protocol::REPORT_VSWING_OFF;
-    if (this->vertical_swing_state_ == vertical_swing_options::OFF)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_OFF;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::FULL)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_FULL;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::DOWN)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_DOWN;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::MIDD)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_MIDD;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::MID)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_MID;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::MIDU)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_MIDU;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::UP)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_UP;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CDOWN)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_CDOWN;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CMIDD)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_CMIDD;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CMID)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_CMID;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CMIDU)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_CMIDU;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CUP)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_CUP;
-    }
-    else
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_OFF;
-    }
-    packet[protocol::REPORT_VSWING_BYTE] |= (mode_vertical_swing << protocol::REPORT_VSWING_POS);
+    this->publish_statistic(StatisticsSensor::UNKNOWN_PACKETS, this->unknown_packets_);
+    this->publish_statistic(StatisticsSensor::IDENTICAL_REPORTS, this->identical_reports_);
+    this->publish_statistic(StatisticsSensor::COALESCED_CHANGES, this->coalesced_changes_);
+    this->publish_statistic(StatisticsSensor::UPDATE_RETRIES, this->update_retries_total_);
+    this->publish_statistic(StatisticsSensor::FAILED_UPDATES, this->failed_updates_);
 
-    /* HORIZONTAL SWING --------------------------------------------------------------------------- */
-    uint8_t mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
-    if (this->horizontal_swing_state_ == horizontal_swing_options::OFF)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::FULL)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_FULL;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CLEFT)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CLEFT;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMIDL)
+    /* unknown if nothing was changed, bucket bound is capped by the max so the open ended bucket reads as the max */
+    uint32_t p50 = this->tx_latency_.percentile(50);
+    if (p50 == 0)
     {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CMIDL;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMID)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CMID;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMIDR)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CMIDR;
+        this->publish_statistic(StatisticsSensor::TX_LATENCY_P50, NAN);
+        this->publish_statistic(StatisticsSensor::TX_LATENCY_P99, NAN);
+        return;
     }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CRIGHT)
+    p50 = std::min(p50, this->tx_latency_max_);
+    uint32_t p99 = std::min(this->tx_latency_.percentile(99), this->tx_latency_max_);
+    ESP_LOGD(TAG, "Update TX latency: p50 <= %u ms, p99 <= %u ms, max %u ms",
+             (unsigned) p50, (unsigned) p99, (unsigned) this->tx_latency_max_);
+    this->publish_statistic(StatisticsSensor::TX_LATENCY_P50, p50);
+    this->publish_statistic(StatisticsSensor::TX_LATENCY_P99, p99);
+
+    this->tx_latency_ = {this->tx_latency_.first_bound, {}};
+    this->tx_latency_max_ = 0;
+}
+
+void SinclairACCNT::set_update_coalesce_window(uint32_t window)
+{
+    this->update_coalesce_window_ = window;
+}
+
+/*
+ * Decide if it is time to send next frame to AC:
+ * - while AC does not respond - with period growing up to init_refresh_max_
+ * - while changes are being coalesced - not at all, UpdateStart takes the first slot after the window
+ * - while an update is in progress - right after the response came, or when it did not come within fast_refresh_interval_
+ * - otherwise - keep-alive idle_refresh_interval_ after the report, or after our frame when no report came for it
+ * Frame is never sent while our previous frame or a report from AC is still on the wire.
+ */
+bool SinclairACCNT::refresh_due()
+{
+    uint32_t since_sent = this->clock_() - this->last_packet_sent_;
+
+    if (since_sent < protocol::TIME_SET_AIRTIME_MS || this->serialProcess_.state == STATE_RECIEVE)
     {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CRIGHT;
+        /* report being recieved is handed over on completion and its response slot is used then */
+        return false;
     }
-    else
+
+    if (this->state_ != ACState::Ready)
     {
-        mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
+        return since_sent >= this->init_refresh_interval_;
     }
-    packet[protocol::REPORT_HSWING_BYTE] |= (mode_horizontal_swing << protocol::REPORT_HSWING_POS);
 
-    /* DISPLAY --------------------------------------------------------------------------- */
-    uint8_t display_mode = protocol::REPORT_DISP_MODE_AUTO;
-    if (this->display_state_ == display_options::AUTO)
+    if (this->update_ == ACUpdate::UpdatePending && this->clock_() - this->update_requested_ < this->update_delay_)
     {
-        display_mode = protocol::REPORT_DISP_MODE_AUTO;
-        this->display_power_internal_ = true;
+        /* changes are still being collected - the response slot is kept for UpdateStart */
+        return false;
     }
-    else if (this->display_state_ == display_options::SET)
+
+    if (this->update_ != ACUpdate::NoUpdate || this->confirm_pending_)
     {
-        display_mode = protocol::REPORT_DISP_MODE_SET;
-        this->display_power_internal_ = true;
+        /* response can not come earlier than airtime of our frame and the report allows */
+        return !this->wait_response_ || since_sent >= std::max<uint32_t>(this->fast_refresh_interval_, protocol::TIME_RESPONSE_MIN_MS);
     }
-    else if (this->display_state_ == display_options::ACT)
+
+    if (this->wait_response_)
     {
-        display_mode = protocol::REPORT_DISP_MODE_ACT;
-        this->display_power_internal_ = true;
+        /* no report came for our frame - poll again */
+        return since_sent >= this->idle_refresh_interval_;
     }
-    else if (this->display_state_ == display_options::OUT)
+    /* keep-alive takes the slot a period after the report, reports AC sends on its own do not hold it back forever */
+    return this->clock_() - this->last_packet_received_ >= this->idle_refresh_interval_ ||
+           since_sent >= 2 * this->idle_refresh_interval_;
+}
+
+/*
+ * Time without reports after which AC is considered not responding - two missed keep-alive reports are allowed,
+ * the third one may still be on its way: keep-alive follows the last report by idle_refresh_interval_, unanswered
+ * ones are repeated after the same period, the answer takes at least TIME_RESPONSE_MIN_MS
+ */
+uint32_t SinclairACCNT::inactive_timeout()
+{
+    return std::max<uint32_t>(protocol::TIME_TIMEOUT_INACTIVE_MS,
+                              3 * this->idle_refresh_interval_ + protocol::TIME_RESPONSE_MIN_MS);
+}
+
+void SinclairACCNT::set_fast_refresh_interval(uint32_t interval)
+{
+    this->fast_refresh_interval_ = interval;
+    this->init_refresh_interval_ = interval;
+}
+
+void SinclairACCNT::set_idle_refresh_interval(uint32_t interval)
+{
+    this->idle_refresh_interval_ = interval;
+}
+
+void SinclairACCNT::set_initializing_refresh_max(uint32_t interval)
+{
+    this->init_refresh_max_ = interval;
+}
+
+/*
+ * Send a raw packet, as is
+ */
+void SinclairACCNT::send_packet()
+{
+    if (!this->refresh_due())
     {
-        display_mode = protocol::REPORT_DISP_MODE_OUT;
-        this->display_power_internal_ = true;
+        /* do net send packet too often or when we are waiting for report to come */
+        return;
     }
-    else if (this->display_state_ == display_options::OFF)
+
+    if (this->state_ != ACState::Ready)
     {
-        /* we do not want to alter display setting - only turn it off */
-        this->display_power_internal_ = false;
-        if (this->display_mode_internal_ == display_options::AUTO)
-        {
-            display_mode = protocol::REPORT_DISP_MODE_AUTO;
-        }
-        else if (this->display_mode_internal_ == display_options::SET)
-        {
-            display_mode = protocol::REPORT_DISP_MODE_SET;
-        }
-        else if (this->display_mode_internal_ == display_options::ACT)
-        {
-            display_mode = protocol::REPORT_DISP_MODE_ACT;
-        }
-        else if (this->display_mode_internal_ == display_options::OUT)
-        {
-            display_mode = protocol::REPORT_DISP_MODE_OUT;
-        }
-        else
-        {
-            display_mode = protocol::REPORT_DISP_MODE_AUTO;
-        }
+        /* AC does not respond - back off, so the bus and CPU are not busy for nothing */
+        this->init_refresh_interval_ = std::min(this->init_refresh_interval_ * 2, this->init_refresh_max_);
     }
-    else
+
+    /* changes are collected for a while, so a burst of them goes to AC as a single update */
+    if (this->update_ == ACUpdate::UpdatePending && this->clock_() - this->update_requested_ >= this->update_delay_)
     {
-        display_mode = protocol::REPORT_DISP_MODE_AUTO;
-        this->display_power_internal_ = true;
+        this->update_ = ACUpdate::UpdateStart;
     }
 
-    packet[protocol::REPORT_DISP_MODE_BYTE] |= (display_mode << protocol::REPORT_DISP_MODE_POS);
+    /* SET frame is kept between calls, only fields which source has changed since last time are encoded again */
+    bool all = !this->set_frame_valid_;
+    this->set_frame_valid_ = true;
 
-    if (this->display_power_internal_)
+    /* this handles tricky part of 0xAF value and flag marking that WiFi does not apply any changes */
+    switch(this->update_)
     {
-        packet[protocol::REPORT_DISP_ON_BYTE] |= protocol::REPORT_DISP_ON_MASK;
+        default:
+        case ACUpdate::NoUpdate:
+        case ACUpdate::UpdatePending:
+            this->set_frame_.encode_update(false, false);
+            break;
+        case ACUpdate::UpdateStart:
+            this->set_frame_.encode_update(true, true);
+            /* local settings are ahead of the last report now, make sure the next one gets decoded */
+            this->last_report_len_ = 0;
+            /* and checked against what is being sent */
+            this->desired_.mode = this->mode;
+            this->desired_.target_temperature = this->target_temperature;
+            this->desired_.settings = this->settings_;
+            this->confirm_pending_ = true;
+            this->update_sent_ = this->clock_();
+            if (this->update_retries_ == 0)
+            {
+                uint32_t latency = this->clock_() - this->update_requested_;
+                this->tx_latency_.add(latency);
+                this->tx_latency_max_ = std::max(this->tx_latency_max_, latency);
+            }
+            break;
+        case ACUpdate::UpdateClear:
+            this->set_frame_.encode_update(false, true);
+            break;
     }
 
-    /* DISPLAY UNIT --------------------------------------------------------------------------- */
-    if (this->display_unit_state_ == display_unit_options::DEGF)
+    /* MODE and POWER --------------------------------------------------------------------------- */
+    if (all || this->mode != this->set_source_.mode || this->mode_internal_ != this->set_source_.mode_internal)
     {
-        packet[protocol::REPORT_DISP_F_BYTE] |= protocol::REPORT_DISP_F_MASK;
+        this->set_source_.mode = this->mode;
+        this->set_source_.mode_internal = this->mode_internal_;
+
+        uint8_t mode = report_mode(this->mode);
+        bool power = (mode != OPTION_INVALID);
+        if (!power)
+        {
+            /* In case of MODE_OFF we will not alter the last mode setting recieved from AC, see determine_mode() */
+            mode = report_mode(this->mode_internal_);
+            if (mode == OPTION_INVALID)
+            {
+                mode = protocol::REPORT_MODE_AUTO;
+            }
+        }
+        this->set_frame_.encode_mode(mode, power);
     }
 
-    /* PLASMA --------------------------------------------------------------------------- */
-    if (this->plasma_state_)
+    /* TARGET TEMPERATURE --------------------------------------------------------------------------- */
+    if (all || this->target_temperature != this->set_source_.target_temperature)
     {
-        packet[protocol::REPORT_PLASMA1_BYTE] |= protocol::REPORT_PLASMA1_MASK;
-        packet[protocol::REPORT_PLASMA2_BYTE] |= protocol::REPORT_PLASMA2_MASK;
+        this->set_source_.target_temperature = this->target_temperature;
+        this->set_frame_.encode_target_temperature((uint8_t) this->target_temperature);
     }
 
-    /* SLEEP --------------------------------------------------------------------------- */
-    if (this->sleep_state_)
+    /* FAN SPEED --------------------------------------------------------------------------- */
+    if (all || this->settings_.fan_mode != this->set_source_.settings.fan_mode)
     {
-        packet[protocol::REPORT_SLEEP_BYTE] |= protocol::REPORT_SLEEP_MASK;
+        this->set_source_.settings.fan_mode = this->settings_.fan_mode;
+        this->set_frame_.encode_fan_mode(this->settings_.fan_mode);
     }
 
-    /* XFAN --------------------------------------------------------------------------- */
-    if (this->xfan_state_)
+    /* VERTICAL SWING --------------------------------------------------------------------------- */
+    if (all || this->settings_.vertical_swing != this->set_source_.settings.vertical_swing)
     {
-        packet[protocol::REPORT_XFAN_BYTE] |= protocol::REPORT_XFAN_MASK;
+        this->set_source_.settings.vertical_swing = this->settings_.vertical_swing;
+        this->set_frame_.encode_vertical_swing(this->settings_.vertical_swing);
     }
 
-    /* SAVE --------------------------------------------------------------------------- */
-    if (this->save_state_)
+    /* HORIZONTAL SWING --------------------------------------------------------------------------- */
+    if (all || this->settings_.horizontal_swing != this->set_source_.settings.horizontal_swing)
     {
-        packet[protocol::REPORT_SAVE_BYTE] |= protocol::REPORT_SAVE_MASK;
+        this->set_source_.settings.horizontal_swing = this->settings_.horizontal_swing;
+        this->set_frame_.encode_horizontal_swing(this->settings_.horizontal_swing);
     }
-    
-    /* Do the command, length */
-    packet.insert(packet.begin(), protocol::CMD_OUT_PARAMS_SET);
-    packet.insert(packet.begin(), protocol::SET_PACKET_LEN + 2); /* Add 2 bytes as we added a command and will add checksum */
 
-    /* Do checksum - sum of all bytes except sync and checksum itself% 0x100 
-       the module would be realized by the fact that we are using uint8_t*/
-    uint8_t checksum = 0;
-    for (uint8_t i = 0 ; i < packet.size() ; i++)
+    /* DISPLAY --------------------------------------------------------------------------- */
+    if (all || this->settings_.display != this->set_source_.settings.display || this->settings_.display_mode != this->set_source_.settings.display_mode)
     {
-        checksum += packet[i];
+        this->set_source_.settings.display = this->settings_.display;
+        this->set_source_.settings.display_mode = this->settings_.display_mode;
+        this->display_power_internal_ = this->set_frame_.encode_display(this->settings_.display, this->settings_.display_mode);
     }
-    packet.push_back(checksum);
 
-    /* Do SYNC bytes */
-    packet.insert(packet.begin(), protocol::SYNC);
-    packet.insert(packet.begin(), protocol::SYNC);
+    /* DISPLAY UNIT, PLASMA, SLEEP, XFAN, SAVE - plain bits, patching them costs less than checking for change */
+    this->set_frame_.encode_flags(this->settings_);
 
-    this->last_packet_sent_ = millis();  /* Save the time when we sent the last packet */
+    this->last_packet_sent_ = this->clock_();  /* Save the time when we sent the last packet */
     this->wait_response_ = true;
-    write_array(packet);                 /* Sent the packet by UART */
-    log_packet(packet, true);            /* Log uart for debug purposes */
+    this->link_stats_.tx_frames++;
+    write_array(this->set_frame_.data(), this->set_frame_.size()); /* Sent the packet by UART */
+    log_packet(this->set_frame_.data(), this->set_frame_.size(), true); /* Log uart for debug purposes */
 
     /* update setting state-machine */
     switch(this->update_)
     {
         case ACUpdate::NoUpdate:
+        case ACUpdate::UpdatePending:
             break;
         case ACUpdate::UpdateStart:
             this->update_ = ACUpdate::UpdateClear;
@@ -535,102 +540,147 @@ void SinclairACCNT::send_packet()
  * Packet handling
  */
 
-bool SinclairACCNT::verify_packet()
+bool SinclairACCNT::is_valid_header(uint8_t len, uint8_t cmd)
+{
+    /* unknown commands are accepted here, they are dropped later by verify_packet() */
+    return CNT::is_valid_header(len, cmd);
+}
+
+bool SinclairACCNT::verify_packet(const FrameView &frame)
 {
     /* At least 2 sync bytes + length + type + checksum */
-    if (this->serialProcess_.data.size() < 5)
+    if (frame.len < 5)
     {
         ESP_LOGW(TAG, "Dropping invalid packet (length)");
+        this->link_stats_.length_errors++;
         return false;
     }
 
     /* The header (aka sync bytes) was checked by SinclairAC::read_data() */
 
-    /* The frame len was assumed by SinclairAC::read_data() */
+    /* The frame len was checked against the command by SinclairAC::read_data(), see is_valid_header() */
 
     /* Check if this packet type sould be processed */
-    bool commandAllowed = false;
-    for (uint8_t packet : allowedPackets)
+    const PacketType_t &type = packet_type(frame[3]);
+    if (type.handler == PacketHandler::NONE)
     {
-        if (this->serialProcess_.data[3] == packet)
-        {
-            commandAllowed = true;
-            break;
-        }
-    }
-    if (!commandAllowed)
-    {
-        ESP_LOGW(TAG, "Dropping invalid packet (command [%02X] not allowed)", this->serialProcess_.data[3]);
+        this->unknown_packets_++;
+        ESP_LOGV(TAG, "Dropping packet (command [%02X] not processed)", frame[3]);
         return false;
     }
 
-    /* Check checksum - sum of all bytes except sync and checksum itself% 0x100 
-       the module would be realized by the fact that we are using uint8_t*/
-    uint8_t checksum = 0;
-    for (uint8_t i = 2 ; i < this->serialProcess_.data.size() - 1 ; i++)
-    {
-        checksum += this->serialProcess_.data[i];
-    }
-    if (checksum != this->serialProcess_.data[this->serialProcess_.data.size()-1])
+    /* The checksum was checked by SinclairAC::read_data() while recieving */
+
+    return true;
+}
+
+void SinclairACCNT::replay_frame(const FrameView &frame)
+{
+    log_packet(frame.data, frame.len);
+
+    /* framing passed, but without verify_packet() - replayed frames are not counted */
+    if (frame.len < 5 || packet_type(frame[3]).handler == PacketHandler::NONE)
     {
-        ESP_LOGD(TAG, "Dropping invalid packet (checksum)");
-        return false;
+        ESP_LOGD(TAG, "Replayed packet not processed (command [%02X])", frame[3]);
+        return;
     }
+    this->handle_packet(frame);
+}
 
-    return true;
+const SinclairACCNT::PacketHandler_t SinclairACCNT::PACKET_HANDLERS[(size_t) PacketHandler::COUNT] = {
+    nullptr,                             /* NONE */
+    &SinclairACCNT::handle_unit_report,  /* UNIT_REPORT */
+};
+
+void SinclairACCNT::handle_packet(const FrameView &frame)
+{
+    /* payload skips unnecessary elements - header and checksum, nothing is moved */
+    FrameView payload = {frame.data + 4, (uint8_t) (frame.len - 5)};
+    /* verify_packet() made sure there is a handler for this command */
+    (this->*PACKET_HANDLERS[(size_t) packet_type(frame[3]).handler])(payload);
 }
 
-void SinclairACCNT::handle_packet()
+void SinclairACCNT::handle_unit_report(const FrameView &payload)
 {
-    if (this->serialProcess_.data[3] == protocol::CMD_IN_UNIT_REPORT)
+    /* header check keeps length of recieved reports within bounds, still never copy nor decode past them */
+    if (payload.len < protocol::REPORT_PAYLOAD_MIN || payload.len > sizeof(this->last_report_))
     {
-        /* here we will remove unnecessary elements - header and checksum */
-        this->serialProcess_.data.erase(this->serialProcess_.data.begin(), this->serialProcess_.data.begin() + 4); /* remove header */
-        this->serialProcess_.data.pop_back();  /* remove checksum */
-        /* now process the data */
-        this->processUnitReport();
-        this->publish_state();
+        ESP_LOGW(TAG, "Dropping unit report of unexpected length %u", (unsigned) payload.len);
+        return;
     }
-    else 
+
+    /* report that was already on the wire when AC got the update can not show it, it would only bring
+       the old settings back - the next one is checked instead */
+    if (this->confirm_pending_ &&
+        this->clock_() - this->update_sent_ < protocol::TIME_SET_AIRTIME_MS + protocol::airtime_ms(payload.len + 5))
+    {
+        ESP_LOGV(TAG, "Skipping unit report sent before the update");
+        return;
+    }
+
+    /* AC repeats the same report over and over - there is nothing new to decode nor publish in that case */
+    if (payload.len == this->last_report_len_ && memcmp(payload.data, this->last_report_, payload.len) == 0)
     {
-        ESP_LOGD(TAG, "Received unknown packet");
+        this->identical_reports_++;
+        return;
+    }
+    memcpy(this->last_report_, payload.data, payload.len);
+    this->last_report_len_ = payload.len;
+
+    uint16_t dirty = this->processUnitReport(payload);
+    if (!this->confirm_update())
+    {
+        /* update is being retried - changes from this report are published once it is confirmed */
+        this->pending_publish_ |= dirty;
+        return;
     }
+    this->publish_changes(dirty);
 }
 
 /*
- * This decodes frame recieved from AC Unit
+ * This decodes frame recieved from AC Unit, returns report_fields that have changed
  */
-bool SinclairACCNT::processUnitReport()
+uint16_t SinclairACCNT::processUnitReport(const FrameView &payload)
 {
-    bool hasChanged = false;
+    uint16_t dirty = 0;
 
-    climate::ClimateMode newMode = determine_mode();
-    if (this->mode != newMode) hasChanged = true;
+    UnitReport_t report;
+    if (!decode_unit_report(payload, report))
+    {
+        return dirty;
+    }
+
+    if (report.unknown & report_unknown::MODE)             ESP_LOGW(TAG, "Received unknown climate mode");
+    if (report.unknown & report_unknown::FAN_MODE)         ESP_LOGW(TAG, "Received unknown fan mode");
+    if (report.unknown & report_unknown::VERTICAL_SWING)   ESP_LOGW(TAG, "Received unknown vertical swing mode");
+    if (report.unknown & report_unknown::HORIZONTAL_SWING) ESP_LOGW(TAG, "Received unknown horizontal swing mode");
+    if (report.unknown & report_unknown::DISPLAY_MODE)     ESP_LOGW(TAG, "Received unknown display mode");
+
+    climate::ClimateMode newMode = determine_mode(report);
+    if (this->mode != newMode) dirty |= report_fields::MODE;
     this->mode = newMode;
 
-    std::string newFanMode = determine_fan_mode();
-    if (this->custom_fan_mode != newFanMode) hasChanged = true;
-    this->custom_fan_mode = newFanMode;
+    uint8_t newFanMode = report.settings.fan_mode;
+    if (this->settings_.fan_mode != newFanMode || !this->custom_fan_mode.has_value())
+    {
+        dirty |= report_fields::FAN_MODE;
+        this->settings_.fan_mode = newFanMode;
+        this->custom_fan_mode = fan_modes::NAMES[newFanMode];
+    }
     
-    float newTargetTemperature = (float)(((this->serialProcess_.data[protocol::REPORT_TEMP_SET_BYTE] & protocol::REPORT_TEMP_SET_MASK) >> protocol::REPORT_TEMP_SET_POS)
-        + protocol::REPORT_TEMP_SET_OFF);
-    if (this->target_temperature != newTargetTemperature) hasChanged = true;
-    this->update_target_temperature(newTargetTemperature);
+    if (this->update_target_temperature((float) report.target_temperature)) dirty |= report_fields::TARGET_TEMPERATURE;
     
     /* if there is no external sensor mapped to represent current temperature we will get data from AC unit */
     if (this->current_temperature_sensor_ == nullptr)
     {
-        float newCurrentTemperature = (float)(((this->serialProcess_.data[protocol::REPORT_TEMP_ACT_BYTE] & protocol::REPORT_TEMP_ACT_MASK) >> protocol::REPORT_TEMP_ACT_POS)
-            - protocol::REPORT_TEMP_ACT_OFF) / protocol::REPORT_TEMP_ACT_DIV;
-        if (this->current_temperature != newCurrentTemperature) hasChanged = true;
-        this->update_current_temperature(newCurrentTemperature);
+        if (this->update_current_temperature(report.current_temperature)) dirty |= report_fields::CURRENT_TEMPERATURE;
     }
 
-    std::string verticalSwing = determine_vertical_swing();
-    std::string horizontalSwing = determine_horizontal_swing();
+    uint8_t verticalSwing = report.settings.vertical_swing;
+    uint8_t horizontalSwing = report.settings.horizontal_swing;
 
-    this->update_swing_vertical(verticalSwing);
-    this->update_swing_horizontal(horizontalSwing);
+    if (this->update_swing_vertical(verticalSwing)) dirty |= report_fields::VERTICAL_SWING;
+    if (this->update_swing_horizontal(horizontalSwing)) dirty |= report_fields::HORIZONTAL_SWING;
 
     climate::ClimateSwingMode newSwingMode;
     /* update legacy swing mode to somehow represent actual state and support
@@ -644,31 +694,31 @@ bool SinclairACCNT::processUnitReport()
     else
         newSwingMode = climate::CLIMATE_SWING_OFF;
     
-    if (this->swing_mode != newSwingMode) hasChanged = true;
+    if (this->swing_mode != newSwingMode) dirty |= report_fields::SWING_MODE;
     this->swing_mode = newSwingMode;
 
-    this->update_display(determine_display());
-    this->update_display_unit(determine_display_unit());
+    /* display mode is kept even while display is OFF, so it can be restored */
+    this->display_power_internal_ = report.display_power;
+    this->settings_.display_mode = report.settings.display_mode;
+    if (this->update_display(report.settings.display)) dirty |= report_fields::DISPLAY;
+    if (this->update_display_unit(report.settings.display_unit)) dirty |= report_fields::DISPLAY_UNIT;
 
-    this->update_plasma(determine_plasma());
-    this->update_sleep(determine_sleep());
-    this->update_xfan(determine_xfan());
-    this->update_save(determine_save());
+    if (this->update_plasma(report.settings.plasma)) dirty |= report_fields::PLASMA;
+    if (this->update_sleep(report.settings.sleep)) dirty |= report_fields::SLEEP;
+    if (this->update_xfan(report.settings.xfan)) dirty |= report_fields::XFAN;
+    if (this->update_save(report.settings.save)) dirty |= report_fields::SAVE;
 
-    return hasChanged;
+    return dirty;
 }
 
-climate::ClimateMode SinclairACCNT::determine_mode()
+climate::ClimateMode SinclairACCNT::determine_mode(const UnitReport_t &report)
 {
-    uint8_t mode = (this->serialProcess_.data[protocol::REPORT_MODE_BYTE] & protocol::REPORT_MODE_MASK) >> protocol::REPORT_MODE_POS;
-
     /* as mode presented by climate component incorporates both power and mode we will store this separately for Sinclair
        in _internal_ fields */
-    /* check unit power flag */
-    this->power_internal_ = (this->serialProcess_.data[protocol::REPORT_PWR_BYTE] & protocol::REPORT_PWR_MASK) != 0;
+    this->power_internal_ = report.power;
 
     /* check unit mode */
-    switch (mode)
+    switch (report.mode)
     {
         case protocol::REPORT_MODE_AUTO:
             this->mode_internal_ = climate::CLIMATE_MODE_AUTO;
@@ -686,7 +736,6 @@ climate::ClimateMode SinclairACCNT::determine_mode()
             this->mode_internal_ = climate::CLIMATE_MODE_HEAT;
             break;
         default:
-            ESP_LOGW(TAG, "Received unknown climate mode");
             this->mode_internal_ = climate::CLIMATE_MODE_OFF;
             break;
     }
@@ -702,269 +751,121 @@ climate::ClimateMode SinclairACCNT::determine_mode()
     }
 }
 
-std::string SinclairACCNT::determine_fan_mode()
-{
-    /* fan setting has quite complex representation in the packet, brace for it */
-    uint8_t fanSpeed1 = (this->serialProcess_.data[protocol::REPORT_FAN_SPD1_BYTE]  & protocol::REPORT_FAN_SPD1_MASK) >> protocol::REPORT_FAN_SPD1_POS;
-    uint8_t fanSpeed2 = (this->serialProcess_.data[protocol::REPORT_FAN_SPD2_BYTE]  & protocol::REPORT_FAN_SPD2_MASK) >> protocol::REPORT_FAN_SPD2_POS;
-    bool    fanQuiet  = (this->serialProcess_.data[protocol::REPORT_FAN_QUIET_BYTE] & protocol::REPORT_FAN_QUIET_MASK) != 0;
-    bool    fanTurbo  = (this->serialProcess_.data[protocol::REPORT_FAN_TURBO_BYTE] & protocol::REPORT_FAN_TURBO_MASK) != 0;
-    /* we have extracted all the data, let's do the processing */
-    if      (fanSpeed1 == 0 && fanSpeed2 == 0 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_AUTO;
-    }
-    else if (fanSpeed1 == 1 && fanSpeed2 == 1 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_LOW;
-    }
-    else if (fanSpeed1 == 1 && fanSpeed2 == 1 && fanQuiet == true  && fanTurbo == false)
-    {
-        return fan_modes::FAN_QUIET;
-    }
-    else if (fanSpeed1 == 2 && fanSpeed2 == 2 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_MEDL;
-    }
-    else if (fanSpeed1 == 3 && fanSpeed2 == 2 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_MED;
-    }
-    else if (fanSpeed1 == 4 && fanSpeed2 == 3 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_MEDH;
-    }
-    else if (fanSpeed1 == 5 && fanSpeed2 == 3 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_HIGH;
-    }
-    else if (fanSpeed1 == 5 && fanSpeed2 == 3 && fanQuiet == false && fanTurbo == true )
-    {
-        return fan_modes::FAN_TURBO;
-    }
-    else 
-    {
-        ESP_LOGW(TAG, "Received unknown fan mode");
-        return fan_modes::FAN_AUTO;
-    }
-}
-
-std::string SinclairACCNT::determine_vertical_swing()
-{
-    uint8_t mode = (this->serialProcess_.data[protocol::REPORT_VSWING_BYTE]  & protocol::REPORT_VSWING_MASK) >> protocol::REPORT_VSWING_POS;
-
-    switch (mode) {
-        case protocol::REPORT_VSWING_OFF:
-            return vertical_swing_options::OFF;
-        case protocol::REPORT_VSWING_FULL:
-            return vertical_swing_options::FULL;
-        case protocol::REPORT_VSWING_DOWN:
-            return vertical_swing_options::DOWN;
-        case protocol::REPORT_VSWING_MIDD:
-            return vertical_swing_options::MIDD;
-        case protocol::REPORT_VSWING_MID:
-            return vertical_swing_options::MID;
-        case protocol::REPORT_VSWING_MIDU:
-            return vertical_swing_options::MIDU;
-        case protocol::REPORT_VSWING_UP:
-            return vertical_swing_options::UP;
-        case protocol::REPORT_VSWING_CDOWN:
-            return vertical_swing_options::CDOWN;
-        case protocol::REPORT_VSWING_CMIDD:
-            return vertical_swing_options::CMIDD;
-        case protocol::REPORT_VSWING_CMID:
-            return vertical_swing_options::CMID;
-        case protocol::REPORT_VSWING_CMIDU:
-            return vertical_swing_options::CMIDU;
-        case protocol::REPORT_VSWING_CUP:
-            return vertical_swing_options::CUP;
-        default:
-            ESP_LOGW(TAG, "Received unknown vertical swing mode");
-            return vertical_swing_options::OFF;;
-    }
-}
-
-std::string SinclairACCNT::determine_horizontal_swing()
-{
-    uint8_t mode = (this->serialProcess_.data[protocol::REPORT_HSWING_BYTE]  & protocol::REPORT_HSWING_MASK) >> protocol::REPORT_HSWING_POS;
-
-    switch (mode) {
-        case protocol::REPORT_HSWING_OFF:
-            return horizontal_swing_options::OFF;
-        case protocol::REPORT_HSWING_FULL:
-            return horizontal_swing_options::FULL;
-        case protocol::REPORT_HSWING_CLEFT:
-            return horizontal_swing_options::CLEFT;
-        case protocol::REPORT_HSWING_CMIDL:
-            return horizontal_swing_options::CMIDL;
-        case protocol::REPORT_HSWING_CMID:
-            return horizontal_swing_options::CMID;
-        case protocol::REPORT_HSWING_CMIDR:
-            return horizontal_swing_options::CMIDR;
-        case protocol::REPORT_HSWING_CRIGHT:
-            return horizontal_swing_options::CRIGHT;
-        default:
-            ESP_LOGW(TAG, "Received unknown horizontal swing mode");
-            return horizontal_swing_options::OFF;
-    }
-}
-
-std::string SinclairACCNT::determine_display()
-{
-    uint8_t mode = (this->serialProcess_.data[protocol::REPORT_DISP_MODE_BYTE] & protocol::REPORT_DISP_MODE_MASK) >> protocol::REPORT_DISP_MODE_POS;
-
-    this->display_power_internal_ = (this->serialProcess_.data[protocol::REPORT_DISP_ON_BYTE] & protocol::REPORT_DISP_ON_MASK);
-
-    switch (mode) {
-        case protocol::REPORT_DISP_MODE_AUTO:
-            this->display_mode_internal_ = display_options::AUTO;
-            break;
-        case protocol::REPORT_DISP_MODE_SET:
-            this->display_mode_internal_ = display_options::SET;
-            break;
-        case protocol::REPORT_DISP_MODE_ACT:
-            this->display_mode_internal_ = display_options::ACT;
-            break;
-        case protocol::REPORT_DISP_MODE_OUT:
-            this->display_mode_internal_ = display_options::OUT;
-            break;
-        default:
-            ESP_LOGW(TAG, "Received unknown display mode");
-            this->display_mode_internal_ = display_options::AUTO;
-            break;
-    }
-
-    if (this->display_power_internal_)
-    {
-        return this->display_mode_internal_;
-    }
-    else
-    {
-        return display_options::OFF;
-    }
-}
-
-std::string SinclairACCNT::determine_display_unit()
-{
-    if (this->serialProcess_.data[protocol::REPORT_DISP_F_BYTE] & protocol::REPORT_DISP_F_MASK)
-    {
-        return display_unit_options::DEGF;
-    }
-    else
-    {
-        return display_unit_options::DEGC;
-    }
-}
-
-bool SinclairACCNT::determine_plasma(){
-    bool plasma1 = (this->serialProcess_.data[protocol::REPORT_PLASMA1_BYTE] & protocol::REPORT_PLASMA1_MASK) != 0;
-    bool plasma2 = (this->serialProcess_.data[protocol::REPORT_PLASMA2_BYTE] & protocol::REPORT_PLASMA2_MASK) != 0;
-    return plasma1 || plasma2;
-}
-
-bool SinclairACCNT::determine_sleep(){
-    return (this->serialProcess_.data[protocol::REPORT_SLEEP_BYTE] & protocol::REPORT_SLEEP_MASK) != 0;
-}
-
-bool SinclairACCNT::determine_xfan(){
-    return (this->serialProcess_.data[protocol::REPORT_XFAN_BYTE] & protocol::REPORT_XFAN_MASK) != 0;
-}
-
-bool SinclairACCNT::determine_save(){
-    return (this->serialProcess_.data[protocol::REPORT_SAVE_BYTE] & protocol::REPORT_SAVE_MASK) != 0;
-}
-
 
 /*
  * Sensor handling
  */
 
-void SinclairACCNT::on_vertical_swing_change(const std::string &swing)
+void SinclairACCNT::on_vertical_swing_change(uint8_t swing)
 {
     if (this->state_ != ACState::Ready)
+    {
+        this->reject_change(report_fields::VERTICAL_SWING);
         return;
+    }
 
     ESP_LOGD(TAG, "Setting vertical swing position");
 
-    this->update_ = ACUpdate::UpdateStart;
-    this->vertical_swing_state_ = swing;
+    this->request_update();
+    this->settings_.vertical_swing = swing;
 }
 
-void SinclairACCNT::on_horizontal_swing_change(const std::string &swing)
+void SinclairACCNT::on_horizontal_swing_change(uint8_t swing)
 {
     if (this->state_ != ACState::Ready)
+    {
+        this->reject_change(report_fields::HORIZONTAL_SWING);
         return;
+    }
 
     ESP_LOGD(TAG, "Setting horizontal swing position");
 
-    this->update_ = ACUpdate::UpdateStart;
-    this->horizontal_swing_state_ = swing;
+    this->request_update();
+    this->settings_.horizontal_swing = swing;
 }
 
-void SinclairACCNT::on_display_change(const std::string &display)
+void SinclairACCNT::on_display_change(uint8_t display)
 {
     if (this->state_ != ACState::Ready)
+    {
+        this->reject_change(report_fields::DISPLAY);
         return;
+    }
 
     ESP_LOGD(TAG, "Setting display mode");
 
-    this->update_ = ACUpdate::UpdateStart;
-    this->display_state_ = display;
+    this->request_update();
+    this->settings_.display = display;
 }
 
-void SinclairACCNT::on_display_unit_change(const std::string &display_unit)
+void SinclairACCNT::on_display_unit_change(uint8_t display_unit)
 {
     if (this->state_ != ACState::Ready)
+    {
+        this->reject_change(report_fields::DISPLAY_UNIT);
         return;
+    }
 
     ESP_LOGD(TAG, "Setting display unit");
 
-    this->update_ = ACUpdate::UpdateStart;
-    this->display_unit_state_ = display_unit;
+    this->request_update();
+    this->settings_.display_unit = display_unit;
 }
 
 void SinclairACCNT::on_plasma_change(bool plasma)
 {
     if (this->state_ != ACState::Ready)
+    {
+        this->reject_change(report_fields::PLASMA);
         return;
+    }
 
     ESP_LOGD(TAG, "Setting plasma");
 
-    this->update_ = ACUpdate::UpdateStart;
-    this->plasma_state_ = plasma;
+    this->request_update();
+    this->settings_.plasma = plasma;
 }
 
 void SinclairACCNT::on_sleep_change(bool sleep)
 {
     if (this->state_ != ACState::Ready)
+    {
+        this->reject_change(report_fields::SLEEP);
         return;
+    }
 
     ESP_LOGD(TAG, "Setting sleep");
 
-    this->update_ = ACUpdate::UpdateStart;
-    this->sleep_state_ = sleep;
+    this->request_update();
+    this->settings_.sleep = sleep;
 }
 
 void SinclairACCNT::on_xfan_change(bool xfan)
 {
     if (this->state_ != ACState::Ready)
+    {
+        this->reject_change(report_fields::XFAN);
         return;
+    }
 
     ESP_LOGD(TAG, "Setting xfan");
 
-    this->update_ = ACUpdate::UpdateStart;
-    this->xfan_state_ = xfan;
+    this->request_update();
+    this->settings_.xfan = xfan;
 }
 
 void SinclairACCNT::on_save_change(bool save)
 {
     if (this->state_ != ACState::Ready)
+    {
+        this->reject_change(report_fields::SAVE);
         return;
+    }
 
     ESP_LOGD(TAG, "Setting save");
 
-    this->update_ = ACUpdate::UpdateStart;
-    this->save_state_ = save;
+    this->request_update();
+    this->settings_.save = save;
 }
 
 }  // namespace CNT
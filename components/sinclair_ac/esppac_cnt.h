@@ -1,4 +1,6 @@
 // based on: https://github.com/DomiStyle/esphome-panasonic-ac
+#include <algorithm>
+
 #include "esphome/components/climate/climate.h"
 #include "esphome/components/climate/climate_mode.h"
 #include "esppac.h"
@@ -13,184 +15,126 @@ enum class ACState {
 };
 
 enum class ACUpdate {
-    NoUpdate,    /* no parameters changed - normally process data, static flag set */
+    NoUpdate,      /* no parameters changed - normally process data, static flag set */
+    UpdatePending, /* parameters changed, collecting more changes until coalescing window ends - static flag set */
     UpdateStart, /* start update with 0xAF and cleared static flag */
     UpdateClear, /* update without 0xAF and cleared static flag */
 };
 
-namespace protocol {
-    /* SYNC */
-    static const uint8_t SYNC                = 0x7E;
-    /* packet types */
-    static const uint8_t CMD_IN_UNIT_REPORT  = 0x31;
-    static const uint8_t CMD_OUT_PARAMS_SET  = 0x01;
-    static const uint8_t CMD_OUT_SYNC_TIME   = 0x03;
-    static const uint8_t CMD_OUT_MAC_REPORT  = 0x04; /* 7e 7e 0d 04 04 00 00 00 AA BB CC DD EE FF 00 -> AA BB CC DD EE FF = MAC address */
-    static const uint8_t CMD_OUT_UNKNOWN_1   = 0x02; /* 7e 7e 10 02 00 00 00 00 00 00 01 00 28 1e 19 23 23 00 b8 */
-    static const uint8_t CMD_IN_UNKNOWN_1    = 0x44; /* 7e 7e 1a 44 01 00 01 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 01 */
-    static const uint8_t CMD_IN_UNKNOWN_2    = 0x33; /* 7e 7e 2f 33 00 00 40 00 09 20 19 0a 00 10 00 14 17 5b 08 08 00 00 00 00 00 00 00 00 01 00 00 0d 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 */
-
-    /* byte indexes are AFTER we remove first 4 bytes from the packet (sync, length, type) as well as a checksum */
-    /* unit report packet data fields, for binary values there is no need to define bit offset/position */
-    static const uint8_t REPORT_PWR_BYTE       = 4;
-    static const uint8_t REPORT_PWR_MASK       = 0b10000000;
-
-    static const uint8_t REPORT_MODE_BYTE      = 4;
-    static const uint8_t REPORT_MODE_MASK      = 0b01110000;
-    static const uint8_t REPORT_MODE_POS       = 4;
-    static const uint8_t REPORT_MODE_AUTO          = 0;
-    static const uint8_t REPORT_MODE_COOL          = 1;
-    static const uint8_t REPORT_MODE_DRY           = 2;
-    static const uint8_t REPORT_MODE_FAN           = 3;
-    static const uint8_t REPORT_MODE_HEAT          = 4;
-
-    static const uint8_t REPORT_FAN_SPD1_BYTE  = 18;
-    static const uint8_t REPORT_FAN_SPD1_MASK  = 0b00001111;
-    static const uint8_t REPORT_FAN_SPD1_POS   = 0;
-    static const uint8_t REPORT_FAN_SPD2_BYTE  = 4;
-    static const uint8_t REPORT_FAN_SPD2_MASK  = 0b00000011;
-    static const uint8_t REPORT_FAN_SPD2_POS   = 0;
-    static const uint8_t REPORT_FAN_QUIET_BYTE = 16;
-    static const uint8_t REPORT_FAN_QUIET_MASK = 0b00001000;
-    static const uint8_t REPORT_FAN_TURBO_BYTE = 6;
-    static const uint8_t REPORT_FAN_TURBO_MASK = 0b00000001;
-
-    static const uint8_t REPORT_TEMP_SET_BYTE  = 5;
-    static const uint8_t REPORT_TEMP_SET_MASK  = 0b11110000;
-    static const uint8_t REPORT_TEMP_SET_POS   = 4;
-    static const uint8_t REPORT_TEMP_SET_OFF   = 16; /* temperature offset from value in packet */
-
-    static const uint8_t REPORT_TEMP_ACT_BYTE  = 42;
-    static const uint8_t REPORT_TEMP_ACT_MASK  = 0b11111111;
-    static const uint8_t REPORT_TEMP_ACT_POS   = 0;
-    static const uint8_t REPORT_TEMP_ACT_OFF   = 16;  /* temperature offset from value in packet */
-    static const float   REPORT_TEMP_ACT_DIV   = 2.0; /* temperature divider from value in packet */
-
-    static const uint8_t REPORT_HSWING_BYTE    = 8;
-    static const uint8_t REPORT_HSWING_MASK    = 0b00000111;
-    static const uint8_t REPORT_HSWING_POS     = 0;
-    static const uint8_t REPORT_HSWING_OFF         = 0;
-    static const uint8_t REPORT_HSWING_FULL        = 1;
-    static const uint8_t REPORT_HSWING_CLEFT       = 2;
-    static const uint8_t REPORT_HSWING_CMIDL       = 3;
-    static const uint8_t REPORT_HSWING_CMID        = 4;
-    static const uint8_t REPORT_HSWING_CMIDR       = 5;
-    static const uint8_t REPORT_HSWING_CRIGHT      = 6;
-
-    static const uint8_t REPORT_VSWING_BYTE    = 8;
-    static const uint8_t REPORT_VSWING_MASK    = 0b11110000;
-    static const uint8_t REPORT_VSWING_POS     = 4;
-    static const uint8_t REPORT_VSWING_OFF         = 0;
-    static const uint8_t REPORT_VSWING_FULL        = 1;
-    static const uint8_t REPORT_VSWING_CUP         = 2;
-    static const uint8_t REPORT_VSWING_CMIDU       = 3;
-    static const uint8_t REPORT_VSWING_CMID        = 4;
-    static const uint8_t REPORT_VSWING_CMIDD       = 5;
-    static const uint8_t REPORT_VSWING_CDOWN       = 6;
-    static const uint8_t REPORT_VSWING_DOWN        = 7;
-    static const uint8_t REPORT_VSWING_MIDD        = 8;
-    static const uint8_t REPORT_VSWING_MID         = 9;
-    static const uint8_t REPORT_VSWING_MIDU        = 10;
-    static const uint8_t REPORT_VSWING_UP          = 11;
-
-    static const uint8_t REPORT_DISP_ON_BYTE   = 6;
-    static const uint8_t REPORT_DISP_ON_MASK   = 0b00000010;
-    static const uint8_t REPORT_DISP_MODE_BYTE = 9;
-    static const uint8_t REPORT_DISP_MODE_MASK = 0b00110000;
-    static const uint8_t REPORT_DISP_MODE_POS  = 4;
-    static const uint8_t REPORT_DISP_MODE_AUTO     = 0;
-    static const uint8_t REPORT_DISP_MODE_SET      = 1;
-    static const uint8_t REPORT_DISP_MODE_ACT      = 2;
-    static const uint8_t REPORT_DISP_MODE_OUT      = 3;
-
-    static const uint8_t REPORT_DISP_F_BYTE    = 7;
-    static const uint8_t REPORT_DISP_F_MASK    = 0b10000000;
-
-    static const uint8_t REPORT_PLASMA1_BYTE   = 6;
-    static const uint8_t REPORT_PLASMA1_MASK   = 0b00000100;
-    static const uint8_t REPORT_PLASMA2_BYTE   = 0;
-    static const uint8_t REPORT_PLASMA2_MASK   = 0b00000100;
-
-    static const uint8_t REPORT_SLEEP_BYTE     = 4;
-    static const uint8_t REPORT_SLEEP_MASK     = 0b00001000;
-
-    static const uint8_t REPORT_XFAN_BYTE      = 6;
-    static const uint8_t REPORT_XFAN_MASK      = 0b00001000;
-
-    static const uint8_t REPORT_SAVE_BYTE      = 11;
-    static const uint8_t REPORT_SAVE_MASK      = 0b01000000;
-
-    /* SET packet shares all the byte definition with REPORT */
-    static const uint8_t SET_PACKET_LEN        = 45;
-    
-    static const uint8_t SET_CONST_02_BYTE     = 39;
-    static const uint8_t SET_CONST_02_VAL      = 0x02;
-
-    static const uint8_t SET_AF_BYTE           = 3;
-    static const uint8_t SET_AF_VAL            = 0xAF;
-
-    static const uint8_t SET_NOCHANGE_BYTE     = 11;
-    static const uint8_t SET_NOCHANGE_MASK     = 0b00001000;
-
-    static const uint8_t SET_CONST_BIT_BYTE    = 7;
-    static const uint8_t SET_CONST_BIT_MASK    = 0b00000010;
-
-    /* time constraints */
-    static const unsigned long TIME_REFRESH_PERIOD_MS   =  300;
-    static const unsigned long TIME_TIMEOUT_INACTIVE_MS = 1000;
-}
-
-/* Define packets from AC that would be processed by software */
-const std::vector<uint8_t> allowedPackets = {protocol::CMD_IN_UNIT_REPORT};
-
 class SinclairACCNT : public SinclairAC {
     public:
         void control(const climate::ClimateCall &call) override;
 
-        void on_horizontal_swing_change(const std::string &swing) override;
-        void on_vertical_swing_change(const std::string &swing) override;
+        void on_horizontal_swing_change(uint8_t swing) override;
+        void on_vertical_swing_change(uint8_t swing) override;
 
-        void on_display_change(const std::string &display) override;
-        void on_display_unit_change(const std::string &display_unit) override;
+        void on_display_change(uint8_t display) override;
+        void on_display_unit_change(uint8_t display_unit) override;
 
         void on_plasma_change(bool plasma) override;
         void on_sleep_change(bool sleep) override;
         void on_xfan_change(bool xfan) override;
         void on_save_change(bool save) override;
 
+        bool is_valid_header(uint8_t len, uint8_t cmd) override;
+        void replay_frame(const FrameView &frame) override;
+
         void setup() override;
         void loop() override;
 
+        uint32_t get_unknown_packets() const { return this->unknown_packets_; }
+        uint32_t get_identical_reports() const { return this->identical_reports_; }
+        uint32_t get_coalesced_changes() const { return this->coalesced_changes_; }
+
+        uint32_t get_update_retries() const { return this->update_retries_total_; }
+        uint32_t get_failed_updates() const { return this->failed_updates_; }
+        /* since statistics were last published */
+        const Histogram &get_tx_latency() const { return this->tx_latency_; }
+
+        void set_update_coalesce_window(uint32_t window);
+        void set_fast_refresh_interval(uint32_t interval);
+        void set_idle_refresh_interval(uint32_t interval);
+        void set_initializing_refresh_max(uint32_t interval);
+
+        void set_apply_latency_sensor(sensor::Sensor *apply_latency_sensor);
+        void set_apply_retries_sensor(sensor::Sensor *apply_retries_sensor);
+
     protected:
         ACState state_ = ACState::Initializing; /* Stores if the AC is responsive or not */
+
+        uint32_t fast_refresh_interval_ = protocol::TIME_REFRESH_PERIOD_MS;   /* response timeout while an update is in progress */
+        uint32_t idle_refresh_interval_ = protocol::TIME_REFRESH_IDLE_MS;     /* keep-alive period when nothing changes */
+        uint32_t init_refresh_max_      = protocol::TIME_REFRESH_INIT_MAX_MS; /* limit of backoff while AC does not respond */
+        uint32_t init_refresh_interval_ = protocol::TIME_REFRESH_PERIOD_MS;   /* current backoff while AC does not respond */
         ACUpdate update_ = ACUpdate::NoUpdate;  /* Stores if we need tu send update to AC or no */
+        uint32_t update_requested_;             /* Stores the time of first change waiting in UpdatePending */
+        uint32_t update_delay_;                 /* Time UpdatePending waits before UpdateStart - coalescing window or retry backoff */
+        uint32_t update_coalesce_window_ = protocol::TIME_UPDATE_COALESCE_MS;
+        uint32_t coalesced_changes_ = 0;        /* changes merged into an already pending update */
+
+        /* settings sent with the last update, checked against the next report */
+        struct {
+            climate::ClimateMode mode;
+            float target_temperature;
+            ACSettings_t settings;
+        } desired_;
+        bool confirm_pending_ = false;          /* desired_ was sent and not yet seen in a report */
+        uint32_t command_start_;                /* Stores the time of the change that started the update */
+        uint32_t update_sent_;                  /* Stores the time at which UpdateStart frame was sent */
+        uint8_t update_retries_ = 0;            /* retries of the current update */
+        uint32_t update_retries_total_ = 0;
+        uint32_t failed_updates_ = 0;           /* updates not applied by AC after UPDATE_RETRIES_MAX retries */
+        Histogram tx_latency_ = {25, {}};       /* ms from first change of an update until UpdateStart frame is sent */
+        uint32_t tx_latency_max_ = 0;
+
+        sensor::Sensor *apply_latency_sensor_ = nullptr; /* time from change request to a report confirming it */
+        sensor::Sensor *apply_retries_sensor_ = nullptr; /* retries needed by the last update */
 
         climate::ClimateMode mode_internal_;
         bool power_internal_;
 
-        std::string display_mode_internal_;
         bool display_power_internal_;
 
-        bool processUnitReport();
+        uint32_t unknown_packets_ = 0;  /* packets recieved from AC of a type with no handler */
 
-        void send_packet();
+        /* payload of the last decoded unit report, identical reports are not decoded again */
+        uint8_t last_report_[protocol::REPORT_LEN_MAX];
+        uint8_t last_report_len_ = 0;   /* 0 - next report has to be decoded */
+        uint32_t identical_reports_ = 0;
+
+        void publish_statistics() override;
+
+        void request_update();
+        bool desired_applied();
+        bool confirm_update();
 
-        bool verify_packet();
-        void handle_packet();
+        /* Handlers of packet types, indexed by PacketHandler of packet_type() */
+        typedef void (SinclairACCNT::*PacketHandler_t)(const FrameView &payload);
+        static const PacketHandler_t PACKET_HANDLERS[(size_t) PacketHandler::COUNT];
 
-        climate::ClimateMode determine_mode();
-        std::string determine_fan_mode();
+        void handle_unit_report(const FrameView &payload);
+        uint16_t processUnitReport(const FrameView &payload);
 
-        std::string determine_vertical_swing();
-        std::string determine_horizontal_swing();
+        /* SET frame is built once and then only patched, see send_packet() */
+        SetFrame set_frame_;
+        bool set_frame_valid_ = false;
+
+        /* state the SET frame fields were last encoded from */
+        struct {
+            climate::ClimateMode mode;
+            climate::ClimateMode mode_internal;
+            float target_temperature;
+            ACSettings_t settings;
+        } set_source_;
+
+        bool refresh_due();
+        uint32_t inactive_timeout();
+        void send_packet();
 
-        std::string determine_display();
-        std::string determine_display_unit();
+        bool verify_packet(const FrameView &frame);
+        void handle_packet(const FrameView &frame);
 
-        bool determine_plasma();
-        bool determine_sleep();
-        bool determine_xfan();
-        bool determine_save();
+        climate::ClimateMode determine_mode(const UnitReport_t &report);
 };
 
 }  // namespace CNT
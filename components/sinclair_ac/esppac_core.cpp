@@ -0,0 +1,485 @@
+// based on: https://github.com/DomiStyle/esphome-panasonic-ac
+#include "esppac_core.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace sinclair_ac {
+
+size_t serial_parse(SerialProcess_t &process, const uint8_t *data, size_t len, HeaderCheck_t header_check, void *ctx, FrameEvent &event)
+{
+    SerialFrame_t *frame = &process.slot[process.fill_slot];
+
+    event = FrameEvent::NONE;
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    switch (process.state)
+    {
+        case STATE_WAIT_SYNC:
+            /* Frame begins with 0x7E 0x7E LEN CMD
+               LEN - frame length in bytes
+               CMD - command
+             */
+            for (size_t i = 0; i < len; i++)
+            {
+                uint8_t c = data[i];
+                if (c == 0x7E)
+                {
+                    if (process.sync_cnt < 2)
+                    {
+                        process.sync_cnt++;
+                    }
+                    continue;
+                }
+                if (process.sync_cnt < 2)
+                {
+                    /* skip garbage up to the next possible sync byte */
+                    const uint8_t *sync = (const uint8_t *) memchr(data + i, 0x7E, len - i);
+                    process.sync_cnt = 0;
+                    if (sync == nullptr)
+                    {
+                        return len;
+                    }
+                    i = (sync - data) - 1;
+                    continue;
+                }
+                process.sync_cnt = 0;
+                if (c < FRAME_LEN_MIN || c > FRAME_LEN_MAX)
+                {
+                    event = FrameEvent::LENGTH_ERROR;
+                    return i + 1;
+                }
+                frame->data[0] = 0x7E;
+                frame->data[1] = 0x7E;
+                frame->data[2] = c;
+                frame->data_cnt = 3;
+
+                process.frame_size = c;
+                process.checksum = c;
+                process.state = STATE_RECIEVE;
+                return i + 1;
+            }
+            return len;
+        case STATE_RECIEVE:
+        {
+            if (frame->data_cnt == 3)
+            {
+                /* CMD byte - now we can tell if LEN makes sense for this kind of frame */
+                uint8_t cmd = data[0];
+                if (!header_check(ctx, frame->data[2], cmd))
+                {
+                    event = FrameEvent::HEADER_ERROR;
+                    /* resync right away, CMD byte may already be a start of the next frame */
+                    process.sync_cnt = (cmd == 0x7E) ? 1 : 0;
+                    process.state = STATE_WAIT_SYNC;
+                    return 1;
+                }
+            }
+
+            /* copy as much of the frame body as we have at once */
+            size_t cnt = std::min(len, (size_t) process.frame_size);
+            memcpy(frame->data + frame->data_cnt, data, cnt);
+            frame->data_cnt += cnt;
+            process.frame_size -= cnt;
+
+            /* checksum - sum of all bytes except sync and checksum itself % 0x100,
+               the last byte of the frame is the checksum itself */
+            size_t sum_cnt = (process.frame_size == 0) ? cnt - 1 : cnt;
+            for (size_t i = 0; i < sum_cnt; i++)
+            {
+                process.checksum += data[i];
+            }
+
+            if (process.frame_size == 0)
+            {
+                process.state = STATE_WAIT_SYNC;
+                if (process.checksum != data[cnt - 1])
+                {
+                    event = FrameEvent::CHECKSUM_ERROR;
+                    return cnt;
+                }
+                /* WE HAVE A FRAME FROM AC */
+                event = FrameEvent::FRAME;
+                if (process.pending != nullptr)
+                {
+                    /* previous frame was not handed back - callers that can not handle it in time lose it */
+                    process.dropped_cnt++;
+                }
+                /* hand the frame over and continue recieving into the other slot */
+                process.pending = frame;
+                process.fill_slot = (process.fill_slot + 1) % RX_SLOTS;
+            }
+            return cnt;
+        }
+        default:
+            process.state = STATE_WAIT_SYNC;
+            process.sync_cnt = 0;
+            return 0;
+    }
+}
+
+void serial_timeout(SerialProcess_t &process)
+{
+    process.timeout_cnt++;
+    process.state = STATE_WAIT_SYNC;
+    process.sync_cnt = 0;
+}
+
+static int8_t hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+size_t parse_hex(const char *text, uint8_t *data, size_t max)
+{
+    size_t cnt = 0;
+    while (*text != '\0')
+    {
+        if (*text == '(')
+        {
+            /* format_hex_pretty() appends decimal byte count - it has to match and end the text */
+            size_t len = 0;
+            const char *digit = text + 1;
+            for (; *digit >= '0' && *digit <= '9' && len <= max; digit++)
+            {
+                len = len * 10 + (*digit - '0');
+            }
+            if (digit == text + 1 || *digit != ')' || len != cnt)
+            {
+                return 0;
+            }
+            text = digit + 1;
+            while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n')
+            {
+                text++;
+            }
+            return *text == '\0' ? cnt : 0;
+        }
+
+        int8_t high = hex_value(*text);
+        if (high < 0)
+        {
+            text++;
+            continue;
+        }
+        int8_t low = hex_value(text[1]);
+        if (low < 0 || cnt >= max)
+        {
+            return 0;
+        }
+        data[cnt++] = (high << 4) | low;
+        text += 2;
+    }
+    return cnt;
+}
+
+namespace CNT {
+
+/* Maps command byte to position in packet type table, built at compile time */
+struct PacketIndex {
+    uint8_t idx[256];
+};
+
+template<typename T, size_t N> static constexpr PacketIndex make_packet_index(const T (&types)[N])
+{
+    PacketIndex index = {};
+    for (size_t i = 1; i < N; i++)
+    {
+        index.idx[types[i].cmd] = i;
+    }
+    return index;
+}
+
+const PacketType_t &packet_type(uint8_t cmd)
+{
+    /* Define packets from AC that would be processed by software, first entry is used for unknown ones */
+    static constexpr PacketType_t types[] = {
+        {0x00,                         0,                         0,                         PacketHandler::NONE},
+        {protocol::CMD_IN_UNIT_REPORT, protocol::REPORT_LEN_MIN,  protocol::REPORT_LEN_MAX,  PacketHandler::UNIT_REPORT},
+        /* not handled - any LEN, models differ in their length, add bounds together with a handler once decoded */
+        {protocol::CMD_IN_UNKNOWN_1,   FRAME_LEN_MIN,             FRAME_LEN_MAX,             PacketHandler::NONE},
+        {protocol::CMD_IN_UNKNOWN_2,   FRAME_LEN_MIN,             FRAME_LEN_MAX,             PacketHandler::NONE},
+    };
+    static constexpr PacketIndex index = make_packet_index(types);
+
+    return types[index.idx[cmd]];
+}
+
+bool is_valid_header(uint8_t len, uint8_t cmd)
+{
+    const PacketType_t &type = packet_type(cmd);
+    if (type.len_min == 0)
+    {
+        /* unknown commands are dropped later, once the whole frame is recieved */
+        return true;
+    }
+    return len >= type.len_min && len <= type.len_max;
+}
+
+/*
+ * Unit report decoding
+ */
+
+static uint8_t decode_fan_mode(const FrameView &payload, UnitReport_t &report)
+{
+    /* fan setting has quite complex representation in the packet, brace for it */
+    protocol::FanCode fan;
+    fan.spd1  = (payload[protocol::REPORT_FAN_SPD1_BYTE]  & protocol::REPORT_FAN_SPD1_MASK) >> protocol::REPORT_FAN_SPD1_POS;
+    fan.spd2  = (payload[protocol::REPORT_FAN_SPD2_BYTE]  & protocol::REPORT_FAN_SPD2_MASK) >> protocol::REPORT_FAN_SPD2_POS;
+    fan.quiet = (payload[protocol::REPORT_FAN_QUIET_BYTE] & protocol::REPORT_FAN_QUIET_MASK) != 0;
+    fan.turbo = (payload[protocol::REPORT_FAN_TURBO_BYTE] & protocol::REPORT_FAN_TURBO_MASK) != 0;
+    /* we have extracted all the data, let's find it in the table */
+    for (uint8_t i = 0; i < fan_modes::COUNT; i++)
+    {
+        const protocol::FanCode &code = protocol::FAN_CODES[i];
+        if (code.spd1 == fan.spd1 && code.spd2 == fan.spd2 && code.quiet == fan.quiet && code.turbo == fan.turbo)
+        {
+            return i;
+        }
+    }
+    report.unknown |= report_unknown::FAN_MODE;
+    return fan_modes::FAN_AUTO;
+}
+
+static uint8_t decode_vertical_swing(const FrameView &payload, UnitReport_t &report)
+{
+    uint8_t mode = (payload[protocol::REPORT_VSWING_BYTE]  & protocol::REPORT_VSWING_MASK) >> protocol::REPORT_VSWING_POS;
+
+    uint8_t option = protocol::VSWING_OPTIONS[mode];
+    if (option == OPTION_INVALID)
+    {
+        report.unknown |= report_unknown::VERTICAL_SWING;
+        return vertical_swing_options::OFF;
+    }
+    return option;
+}
+
+static uint8_t decode_horizontal_swing(const FrameView &payload, UnitReport_t &report)
+{
+    uint8_t mode = (payload[protocol::REPORT_HSWING_BYTE]  & protocol::REPORT_HSWING_MASK) >> protocol::REPORT_HSWING_POS;
+
+    uint8_t option = protocol::HSWING_OPTIONS[mode];
+    if (option == OPTION_INVALID)
+    {
+        report.unknown |= report_unknown::HORIZONTAL_SWING;
+        return horizontal_swing_options::OFF;
+    }
+    return option;
+}
+
+static uint8_t decode_display_mode(const FrameView &payload, UnitReport_t &report)
+{
+    uint8_t mode = (payload[protocol::REPORT_DISP_MODE_BYTE] & protocol::REPORT_DISP_MODE_MASK) >> protocol::REPORT_DISP_MODE_POS;
+
+    uint8_t option = protocol::DISP_MODE_OPTIONS[mode];
+    if (option == OPTION_INVALID)
+    {
+        report.unknown |= report_unknown::DISPLAY_MODE;
+        return display_options::AUTO;
+    }
+    return option;
+}
+
+bool decode_unit_report(const FrameView &payload, UnitReport_t &report)
+{
+    if (payload.len < protocol::REPORT_PAYLOAD_MIN)
+    {
+        return false;
+    }
+
+    report.unknown = 0;
+
+    report.power = (payload[protocol::REPORT_PWR_BYTE] & protocol::REPORT_PWR_MASK) != 0;
+    report.mode = (payload[protocol::REPORT_MODE_BYTE] & protocol::REPORT_MODE_MASK) >> protocol::REPORT_MODE_POS;
+    if (report.mode > protocol::REPORT_MODE_HEAT)
+    {
+        report.unknown |= report_unknown::MODE;
+    }
+
+    report.target_temperature = ((payload[protocol::REPORT_TEMP_SET_BYTE] & protocol::REPORT_TEMP_SET_MASK) >> protocol::REPORT_TEMP_SET_POS)
+        + protocol::REPORT_TEMP_SET_OFF;
+    report.current_temperature = (float)(((payload[protocol::REPORT_TEMP_ACT_BYTE] & protocol::REPORT_TEMP_ACT_MASK) >> protocol::REPORT_TEMP_ACT_POS)
+        - protocol::REPORT_TEMP_ACT_OFF) / protocol::REPORT_TEMP_ACT_DIV;
+
+    report.settings.fan_mode = decode_fan_mode(payload, report);
+    report.settings.vertical_swing = decode_vertical_swing(payload, report);
+    report.settings.horizontal_swing = decode_horizontal_swing(payload, report);
+
+    report.display_power = (payload[protocol::REPORT_DISP_ON_BYTE] & protocol::REPORT_DISP_ON_MASK) != 0;
+    report.settings.display_mode = decode_display_mode(payload, report);
+    report.settings.display = report.display_power ? report.settings.display_mode : (uint8_t) display_options::OFF;
+
+    report.settings.display_unit = (payload[protocol::REPORT_DISP_F_BYTE] & protocol::REPORT_DISP_F_MASK) ?
+        display_unit_options::DEGF : display_unit_options::DEGC;
+
+    report.settings.plasma = (payload[protocol::REPORT_PLASMA1_BYTE] & protocol::REPORT_PLASMA1_MASK) != 0 ||
+                             (payload[protocol::REPORT_PLASMA2_BYTE] & protocol::REPORT_PLASMA2_MASK) != 0;
+    report.settings.sleep = (payload[protocol::REPORT_SLEEP_BYTE] & protocol::REPORT_SLEEP_MASK) != 0;
+    report.settings.xfan = (payload[protocol::REPORT_XFAN_BYTE] & protocol::REPORT_XFAN_MASK) != 0;
+    report.settings.save = (payload[protocol::REPORT_SAVE_BYTE] & protocol::REPORT_SAVE_MASK) != 0;
+    return true;
+}
+
+void decode_set_update(const FrameView &payload, bool &start, bool &apply)
+{
+    if (payload.len < protocol::SET_PACKET_LEN)
+    {
+        start = false;
+        apply = false;
+        return;
+    }
+    start = payload[protocol::SET_AF_BYTE] == protocol::SET_AF_VAL;
+    apply = (payload[protocol::SET_NOCHANGE_BYTE] & protocol::SET_NOCHANGE_MASK) == 0;
+}
+
+/*
+ * SET frame encoding
+ */
+
+/*
+ * Prepare SET frame contents that never change - header and constant bytes
+ */
+void SetFrame::init(uint8_t cmd)
+{
+    this->frame_.fill(0);
+
+    this->frame_[0] = protocol::SYNC;
+    this->frame_[1] = protocol::SYNC;
+    this->frame_[2] = protocol::SET_PACKET_LEN + 2; /* Add 2 bytes as we have a command and a checksum */
+    this->frame_[3] = cmd;
+
+    this->frame_[protocol::SET_FRAME_PAYLOAD + protocol::SET_CONST_02_BYTE]  = protocol::SET_CONST_02_VAL;   /* Some always 0x02 byte... */
+    this->frame_[protocol::SET_FRAME_PAYLOAD + protocol::SET_CONST_BIT_BYTE] = protocol::SET_CONST_BIT_MASK; /* Some always true bit */
+
+    /* Do checksum - sum of all bytes except sync and checksum itself% 0x100
+       the module would be realized by the fact that we are using uint8_t*/
+    uint8_t checksum = 0;
+    for (uint8_t i = 2 ; i < protocol::SET_FRAME_CHECKSUM ; i++)
+    {
+        checksum += this->frame_[i];
+    }
+    this->frame_[protocol::SET_FRAME_CHECKSUM] = checksum;
+}
+
+/*
+ * Replace masked bits of a SET payload byte and correct the checksum accordingly
+ */
+void SetFrame::set_bits(uint8_t byte, uint8_t mask, uint8_t value)
+{
+    uint8_t &data = this->frame_[protocol::SET_FRAME_PAYLOAD + byte];
+    uint8_t updated = (data & ~mask) | (value & mask);
+
+    /* checksum is a plain sum, so it is enough to apply the difference */
+    this->frame_[protocol::SET_FRAME_CHECKSUM] += (uint8_t) (updated - data);
+    data = updated;
+}
+
+void SetFrame::encode_update(bool start, bool apply)
+{
+    /* this handles tricky part of 0xAF value and flag marking that WiFi does not apply any changes */
+    this->set_bits(protocol::SET_AF_BYTE, 0xFF, start ? protocol::SET_AF_VAL : 0);
+    this->set_bits(protocol::SET_NOCHANGE_BYTE, protocol::SET_NOCHANGE_MASK, apply ? 0 : protocol::SET_NOCHANGE_MASK);
+}
+
+void SetFrame::encode_mode(uint8_t mode, bool power)
+{
+    this->set_bits(protocol::REPORT_MODE_BYTE, protocol::REPORT_MODE_MASK, mode << protocol::REPORT_MODE_POS);
+    this->set_bits(protocol::REPORT_PWR_BYTE, protocol::REPORT_PWR_MASK, power ? protocol::REPORT_PWR_MASK : 0);
+}
+
+void SetFrame::encode_target_temperature(uint8_t temperature)
+{
+    this->set_bits(protocol::REPORT_TEMP_SET_BYTE, protocol::REPORT_TEMP_SET_MASK,
+                   (uint8_t) (temperature - protocol::REPORT_TEMP_SET_OFF) << protocol::REPORT_TEMP_SET_POS);
+}
+
+void SetFrame::encode_fan_mode(uint8_t fan_mode)
+{
+    if (fan_mode >= fan_modes::COUNT)
+    {
+        fan_mode = fan_modes::FAN_AUTO;
+    }
+    const protocol::FanCode &fan = protocol::FAN_CODES[fan_mode];
+
+    this->set_bits(protocol::REPORT_FAN_SPD1_BYTE, protocol::REPORT_FAN_SPD1_MASK, fan.spd1 << protocol::REPORT_FAN_SPD1_POS);
+    this->set_bits(protocol::REPORT_FAN_SPD2_BYTE, protocol::REPORT_FAN_SPD2_MASK, fan.spd2 << protocol::REPORT_FAN_SPD2_POS);
+    this->set_bits(protocol::REPORT_FAN_TURBO_BYTE, protocol::REPORT_FAN_TURBO_MASK, fan.turbo ? protocol::REPORT_FAN_TURBO_MASK : 0);
+    this->set_bits(protocol::REPORT_FAN_QUIET_BYTE, protocol::REPORT_FAN_QUIET_MASK, fan.quiet ? protocol::REPORT_FAN_QUIET_MASK : 0);
+}
+
+void SetFrame::encode_vertical_swing(uint8_t vertical_swing)
+{
+    if (vertical_swing >= vertical_swing_options::COUNT)
+    {
+        vertical_swing = vertical_swing_options::OFF;
+    }
+    this->set_bits(protocol::REPORT_VSWING_BYTE, protocol::REPORT_VSWING_MASK,
+                   protocol::VSWING_CODES[vertical_swing] << protocol::REPORT_VSWING_POS);
+}
+
+void SetFrame::encode_horizontal_swing(uint8_t horizontal_swing)
+{
+    if (horizontal_swing >= horizontal_swing_options::COUNT)
+    {
+        horizontal_swing = horizontal_swing_options::OFF;
+    }
+    this->set_bits(protocol::REPORT_HSWING_BYTE, protocol::REPORT_HSWING_MASK,
+                   protocol::HSWING_CODES[horizontal_swing] << protocol::REPORT_HSWING_POS);
+}
+
+bool SetFrame::encode_display(uint8_t display, uint8_t display_mode)
+{
+    bool power = (display != display_options::OFF);
+    if (!power)
+    {
+        /* we do not want to alter display setting - only turn it off */
+        display = display_mode;
+    }
+    uint8_t code = (display < display_options::COUNT) ? protocol::DISP_MODE_CODES[display] : OPTION_INVALID;
+    if (code == OPTION_INVALID)
+    {
+        code = protocol::REPORT_DISP_MODE_AUTO;
+    }
+    this->set_bits(protocol::REPORT_DISP_MODE_BYTE, protocol::REPORT_DISP_MODE_MASK, code << protocol::REPORT_DISP_MODE_POS);
+    this->set_bits(protocol::REPORT_DISP_ON_BYTE, protocol::REPORT_DISP_ON_MASK, power ? protocol::REPORT_DISP_ON_MASK : 0);
+    return power;
+}
+
+void SetFrame::encode_flags(const ACSettings_t &settings)
+{
+    this->set_bits(protocol::REPORT_DISP_F_BYTE, protocol::REPORT_DISP_F_MASK,
+                   settings.display_unit == display_unit_options::DEGF ? protocol::REPORT_DISP_F_MASK : 0);
+    this->set_bits(protocol::REPORT_PLASMA1_BYTE, protocol::REPORT_PLASMA1_MASK, settings.plasma ? protocol::REPORT_PLASMA1_MASK : 0);
+    this->set_bits(protocol::REPORT_PLASMA2_BYTE, protocol::REPORT_PLASMA2_MASK, settings.plasma ? protocol::REPORT_PLASMA2_MASK : 0);
+    this->set_bits(protocol::REPORT_SLEEP_BYTE, protocol::REPORT_SLEEP_MASK, settings.sleep ? protocol::REPORT_SLEEP_MASK : 0);
+    this->set_bits(protocol::REPORT_XFAN_BYTE, protocol::REPORT_XFAN_MASK, settings.xfan ? protocol::REPORT_XFAN_MASK : 0);
+    this->set_bits(protocol::REPORT_SAVE_BYTE, protocol::REPORT_SAVE_MASK, settings.save ? protocol::REPORT_SAVE_MASK : 0);
+}
+
+void SetFrame::encode_current_temperature(float temperature)
+{
+    static const float RAW_MAX = protocol::REPORT_TEMP_ACT_MASK >> protocol::REPORT_TEMP_ACT_POS;
+    float raw = temperature * protocol::REPORT_TEMP_ACT_DIV + protocol::REPORT_TEMP_ACT_OFF;
+    /* out of range (and NaN) values cannot be converted to uint8_t, they end at the nearest end of the field */
+    if (!(raw >= 0))
+    {
+        raw = 0;
+    }
+    else if (raw > RAW_MAX)
+    {
+        raw = RAW_MAX;
+    }
+    this->set_bits(protocol::REPORT_TEMP_ACT_BYTE, protocol::REPORT_TEMP_ACT_MASK,
+                   (uint8_t) raw << protocol::REPORT_TEMP_ACT_POS);
+}
+
+}  // namespace CNT
+}  // namespace sinclair_ac
+}  // namespace esphome
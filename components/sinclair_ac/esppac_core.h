@@ -0,0 +1,487 @@
+// based on: https://github.com/DomiStyle/esphome-panasonic-ac
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* Protocol core - framing, decoding and encoding of frames exchanged with AC.
+   Nothing here may depend on ESPHome, the component classes only wrap it. */
+
+namespace esphome {
+namespace sinclair_ac {
+
+/* Option sets below are defined once as tables, position in NAMES is the option index used
+   by the component (and protocol code tables), every name starts with its index */
+
+/* this must be same as custom fan modes in SinclairAC::traits() */
+namespace fan_modes{
+    enum : uint8_t {
+        FAN_AUTO, FAN_QUIET, FAN_LOW, FAN_MEDL, FAN_MED, FAN_MEDH, FAN_HIGH, FAN_TURBO,
+        COUNT
+    };
+    static constexpr const char *const NAMES[COUNT] = {
+        "0 - Auto",
+        "1 - Quiet",
+        "2 - Low",
+        "3 - Medium-Low",
+        "4 - Medium",
+        "5 - Medium-High",
+        "6 - High",
+        "7 - Turbo",
+    };
+}
+
+/* this must be same as HORIZONTAL_SWING_OPTIONS in climate.py */
+namespace horizontal_swing_options{
+    enum : uint8_t {
+        OFF, FULL, CLEFT, CMIDL, CMID, CMIDR, CRIGHT,
+        COUNT
+    };
+    static constexpr const char *const NAMES[COUNT] = {
+        "0 - OFF",
+        "1 - Swing - Full",
+        "2 - Constant - Left",
+        "3 - Constant - Mid-Left",
+        "4 - Constant - Middle",
+        "5 - Constant - Mid-Right",
+        "6 - Constant - Right",
+    };
+}
+
+/* this must be same as VERTICAL_SWING_OPTIONS in climate.py */
+namespace vertical_swing_options{
+    enum : uint8_t {
+        OFF, FULL, DOWN, MIDD, MID, MIDU, UP, CDOWN, CMIDD, CMID, CMIDU, CUP,
+        COUNT
+    };
+    static constexpr const char *const NAMES[COUNT] = {
+        "00 - OFF",
+        "01 - Swing - Full",
+        "02 - Swing - Down",
+        "03 - Swing - Mid-Down",
+        "04 - Swing - Middle",
+        "05 - Swing - Mid-Up",
+        "06 - Swing - Up",
+        "07 - Constant - Down",
+        "08 - Constant - Mid-Down",
+        "09 - Constant - Middle",
+        "10 - Constant - Mid-Up",
+        "11 - Constant - Up",
+    };
+}
+
+/* this must be same as DISPLAY_OPTIONS in climate.py */
+namespace display_options{
+    enum : uint8_t {
+        OFF, AUTO, SET, ACT, OUT,
+        COUNT
+    };
+    static constexpr const char *const NAMES[COUNT] = {
+        "0 - OFF",
+        "1 - Auto",
+        "2 - Set temperature",
+        "3 - Actual temperature",
+        "4 - Outside temperature",
+    };
+}
+
+/* Finds option index by its name - the index is read from the name, so a single compare confirms it */
+template<size_t N> uint8_t find_option(const char *const (&names)[N], const std::string &name, uint8_t fallback)
+{
+    size_t idx = 0;
+    for (char c : name)
+    {
+        if (c < '0' || c > '9' || idx >= N)
+        {
+            break;
+        }
+        idx = idx * 10 + (c - '0');
+    }
+    if (idx < N && name == names[idx])
+    {
+        return idx;
+    }
+    return fallback;
+}
+
+static const uint8_t OPTION_INVALID = 0xFF;
+
+/* Protocol code -> option index table, inverted at compile time from option -> code table */
+template<size_t N> struct OptionTable {
+    uint8_t option[N];
+
+    uint8_t operator[](uint8_t code) const { return code < N ? this->option[code] : OPTION_INVALID; }
+};
+
+template<size_t N, size_t M> constexpr OptionTable<N> invert_codes(const uint8_t (&codes)[M])
+{
+    OptionTable<N> table = {};
+    for (size_t i = 0; i < N; i++)
+    {
+        table.option[i] = OPTION_INVALID;
+    }
+    for (size_t i = 0; i < M; i++)
+    {
+        if (codes[i] < N)
+        {
+            table.option[codes[i]] = i;
+        }
+    }
+    return table;
+}
+
+/* this must be same as DISPLAY_UNIT_OPTIONS in climate.py */
+namespace display_unit_options{
+    enum : uint8_t {
+        DEGC, DEGF,
+        COUNT
+    };
+    static constexpr const char *const NAMES[COUNT] = {
+        "C",
+        "F",
+    };
+}
+
+/* Whole AC state kept by the component - option fields hold indices to NAMES tables above,
+   strings are materialized only when publishing to selects and climate */
+typedef struct {
+        uint8_t fan_mode         : 3;  /* fan_modes, mirrors custom_fan_mode of climate */
+        uint8_t vertical_swing   : 4;  /* vertical_swing_options */
+        uint8_t horizontal_swing : 3;  /* horizontal_swing_options */
+        uint8_t display          : 3;  /* display_options */
+        uint8_t display_mode     : 3;  /* display_options - last mode reported by AC, kept while display is OFF */
+        uint8_t display_unit     : 1;  /* display_unit_options */
+        uint8_t plasma           : 1;
+        uint8_t sleep            : 1;
+        uint8_t xfan             : 1;
+        uint8_t save             : 1;
+} ACSettings_t;
+
+/* the whole state has to stay within a few bytes per instance, and every option has to fit its field */
+static_assert(sizeof(ACSettings_t) <= 3, "ACSettings_t grew over 3 bytes");
+static_assert(fan_modes::COUNT <= (1 << 3), "fan_mode field too narrow");
+static_assert(vertical_swing_options::COUNT <= (1 << 4), "vertical_swing field too narrow");
+static_assert(horizontal_swing_options::COUNT <= (1 << 3), "horizontal_swing field too narrow");
+static_assert(display_options::COUNT <= (1 << 3), "display and display_mode fields too narrow");
+static_assert(display_unit_options::COUNT <= (1 << 1), "display_unit field too narrow");
+
+typedef enum {
+        STATE_WAIT_SYNC,
+        STATE_RECIEVE
+} SerialProcessState_t;
+
+static const uint8_t DATA_MAX = 200;
+static const uint8_t FRAME_LEN_MIN = 2;             /* LEN covers CMD and checksum at least */
+static const uint8_t FRAME_LEN_MAX = DATA_MAX - 3;  /* the whole frame with sync bytes and LEN must fit into the buffer */
+static const uint8_t RX_SLOTS = 2;       /* one slot is filled while the other one waits to be handled */
+
+typedef struct {
+        uint8_t data[DATA_MAX];  /* statically allocated frame buffer - no heap use while recieving */
+        uint8_t data_cnt;        /* write index, number of valid bytes in data */
+} SerialFrame_t;
+
+/* Non-owning view of recieved data - lets the decoders work in place on any buffer */
+struct FrameView {
+        const uint8_t *data;
+        uint8_t len;
+
+        uint8_t operator[](uint8_t idx) const { return this->data[idx]; }
+};
+
+typedef struct {
+        SerialFrame_t slot[RX_SLOTS];
+        uint8_t fill_slot;       /* index of the slot being filled by the recieve state machine */
+        SerialFrame_t *pending;  /* complete frame waiting to be handled, nullptr if there is none */
+        uint32_t dropped_cnt;    /* frames dropped as both slots were busy (older frame is dropped) */
+        uint32_t timeout_cnt;    /* partial frames discarded as no more data came, see serial_timeout() */
+        uint8_t frame_size;
+        uint8_t checksum;        /* running checksum of the frame being recieved */
+        uint8_t sync_cnt;        /* number of consecutive SYNC bytes seen while waiting for a frame */
+        SerialProcessState_t state;
+} SerialProcess_t;
+
+/* Outcome of a serial_parse() call */
+enum class FrameEvent : uint8_t {
+        NONE,            /* data consumed, no frame completed */
+        FRAME,           /* frame with valid checksum is waiting in SerialProcess_t::pending */
+        LENGTH_ERROR,    /* LEN byte does not fit DATA_MAX, still waiting for sync */
+        HEADER_ERROR,    /* LEN byte does not match the command, frame dropped */
+        CHECKSUM_ERROR,  /* frame dropped */
+};
+
+/* Tells if LEN byte makes sense for given command, ctx is passed through from serial_parse() */
+typedef bool (*HeaderCheck_t)(void *ctx, uint8_t len, uint8_t cmd);
+
+/* Feeds recieved bytes into the frame state machine, returns number of bytes consumed - call again with the rest */
+size_t serial_parse(SerialProcess_t &process, const uint8_t *data, size_t len, HeaderCheck_t header_check, void *ctx, FrameEvent &event);
+/* Discards partially recieved frame, no more data is going to come for it */
+void serial_timeout(SerialProcess_t &process);
+
+/* Parses bytes logged as hex (e.g. "7E.7E.31..." or whole format_hex_pretty() output "7E.7E.2F.31.00 (50)"),
+   any non hex character but the "(N)" length suffix separates bytes. Returns number of bytes stored to data,
+   0 when text is malformed, does not fit or does not match its length suffix */
+size_t parse_hex(const char *text, uint8_t *data, size_t max);
+
+namespace CNT {
+
+namespace protocol {
+    /* SYNC */
+    static const uint8_t SYNC                = 0x7E;
+    /* packet types */
+    static const uint8_t CMD_IN_UNIT_REPORT  = 0x31;
+    static const uint8_t CMD_OUT_PARAMS_SET  = 0x01;
+    static const uint8_t CMD_OUT_SYNC_TIME   = 0x03;
+    static const uint8_t CMD_OUT_MAC_REPORT  = 0x04; /* 7e 7e 0d 04 04 00 00 00 AA BB CC DD EE FF 00 -> AA BB CC DD EE FF = MAC address */
+    static const uint8_t CMD_OUT_UNKNOWN_1   = 0x02; /* 7e 7e 10 02 00 00 00 00 00 00 01 00 28 1e 19 23 23 00 b8 */
+    static const uint8_t CMD_IN_UNKNOWN_1    = 0x44; /* 7e 7e 1a 44 01 00 01 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 01 */
+    static const uint8_t CMD_IN_UNKNOWN_2    = 0x33; /* 7e 7e 2f 33 00 00 40 00 09 20 19 0a 00 10 00 14 17 5b 08 08 00 00 00 00 00 00 00 00 01 00 00 0d 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 */
+
+    /* byte indexes are AFTER we remove first 4 bytes from the packet (sync, length, type) as well as a checksum */
+    /* unit report packet data fields, for binary values there is no need to define bit offset/position */
+    static const uint8_t REPORT_PWR_BYTE       = 4;
+    static const uint8_t REPORT_PWR_MASK       = 0b10000000;
+
+    static const uint8_t REPORT_MODE_BYTE      = 4;
+    static const uint8_t REPORT_MODE_MASK      = 0b01110000;
+    static const uint8_t REPORT_MODE_POS       = 4;
+    static const uint8_t REPORT_MODE_AUTO          = 0;
+    static const uint8_t REPORT_MODE_COOL          = 1;
+    static const uint8_t REPORT_MODE_DRY           = 2;
+    static const uint8_t REPORT_MODE_FAN           = 3;
+    static const uint8_t REPORT_MODE_HEAT          = 4;
+
+    static const uint8_t REPORT_FAN_SPD1_BYTE  = 18;
+    static const uint8_t REPORT_FAN_SPD1_MASK  = 0b00001111;
+    static const uint8_t REPORT_FAN_SPD1_POS   = 0;
+    static const uint8_t REPORT_FAN_SPD2_BYTE  = 4;
+    static const uint8_t REPORT_FAN_SPD2_MASK  = 0b00000011;
+    static const uint8_t REPORT_FAN_SPD2_POS   = 0;
+    static const uint8_t REPORT_FAN_QUIET_BYTE = 16;
+    static const uint8_t REPORT_FAN_QUIET_MASK = 0b00001000;
+    static const uint8_t REPORT_FAN_TURBO_BYTE = 6;
+    static const uint8_t REPORT_FAN_TURBO_MASK = 0b00000001;
+
+    static const uint8_t REPORT_TEMP_SET_BYTE  = 5;
+    static const uint8_t REPORT_TEMP_SET_MASK  = 0b11110000;
+    static const uint8_t REPORT_TEMP_SET_POS   = 4;
+    static const uint8_t REPORT_TEMP_SET_OFF   = 16; /* temperature offset from value in packet */
+
+    static const uint8_t REPORT_TEMP_ACT_BYTE  = 42;
+    static const uint8_t REPORT_TEMP_ACT_MASK  = 0b11111111;
+    static const uint8_t REPORT_TEMP_ACT_POS   = 0;
+    static const uint8_t REPORT_TEMP_ACT_OFF   = 16;  /* temperature offset from value in packet */
+    static const float   REPORT_TEMP_ACT_DIV   = 2.0; /* temperature divider from value in packet */
+
+    static const uint8_t REPORT_HSWING_BYTE    = 8;
+    static const uint8_t REPORT_HSWING_MASK    = 0b00000111;
+    static const uint8_t REPORT_HSWING_POS     = 0;
+    static const uint8_t REPORT_HSWING_OFF         = 0;
+    static const uint8_t REPORT_HSWING_FULL        = 1;
+    static const uint8_t REPORT_HSWING_CLEFT       = 2;
+    static const uint8_t REPORT_HSWING_CMIDL       = 3;
+    static const uint8_t REPORT_HSWING_CMID        = 4;
+    static const uint8_t REPORT_HSWING_CMIDR       = 5;
+    static const uint8_t REPORT_HSWING_CRIGHT      = 6;
+
+    static const uint8_t REPORT_VSWING_BYTE    = 8;
+    static const uint8_t REPORT_VSWING_MASK    = 0b11110000;
+    static const uint8_t REPORT_VSWING_POS     = 4;
+    static const uint8_t REPORT_VSWING_OFF         = 0;
+    static const uint8_t REPORT_VSWING_FULL        = 1;
+    static const uint8_t REPORT_VSWING_CUP         = 2;
+    static const uint8_t REPORT_VSWING_CMIDU       = 3;
+    static const uint8_t REPORT_VSWING_CMID        = 4;
+    static const uint8_t REPORT_VSWING_CMIDD       = 5;
+    static const uint8_t REPORT_VSWING_CDOWN       = 6;
+    static const uint8_t REPORT_VSWING_DOWN        = 7;
+    static const uint8_t REPORT_VSWING_MIDD        = 8;
+    static const uint8_t REPORT_VSWING_MID         = 9;
+    static const uint8_t REPORT_VSWING_MIDU        = 10;
+    static const uint8_t REPORT_VSWING_UP          = 11;
+
+    static const uint8_t REPORT_DISP_ON_BYTE   = 6;
+    static const uint8_t REPORT_DISP_ON_MASK   = 0b00000010;
+    static const uint8_t REPORT_DISP_MODE_BYTE = 9;
+    static const uint8_t REPORT_DISP_MODE_MASK = 0b00110000;
+    static const uint8_t REPORT_DISP_MODE_POS  = 4;
+    static const uint8_t REPORT_DISP_MODE_AUTO     = 0;
+    static const uint8_t REPORT_DISP_MODE_SET      = 1;
+    static const uint8_t REPORT_DISP_MODE_ACT      = 2;
+    static const uint8_t REPORT_DISP_MODE_OUT      = 3;
+
+    /* option (see esppac.h) to packet representation tables and back */
+    struct FanCode {
+        uint8_t spd1;
+        uint8_t spd2;
+        bool    quiet;
+        bool    turbo;
+    };
+    static constexpr FanCode FAN_CODES[fan_modes::COUNT] = {
+        /* FAN_AUTO  */ {0, 0, false, false},
+        /* FAN_QUIET */ {1, 1, true,  false},
+        /* FAN_LOW   */ {1, 1, false, false},
+        /* FAN_MEDL  */ {2, 2, false, false},
+        /* FAN_MED   */ {3, 2, false, false},
+        /* FAN_MEDH  */ {4, 3, false, false},
+        /* FAN_HIGH  */ {5, 3, false, false},
+        /* FAN_TURBO */ {5, 3, false, true },
+    };
+
+    static constexpr uint8_t HSWING_CODES[horizontal_swing_options::COUNT] = {
+        REPORT_HSWING_OFF, REPORT_HSWING_FULL, REPORT_HSWING_CLEFT, REPORT_HSWING_CMIDL,
+        REPORT_HSWING_CMID, REPORT_HSWING_CMIDR, REPORT_HSWING_CRIGHT,
+    };
+    static constexpr auto HSWING_OPTIONS = invert_codes<(REPORT_HSWING_MASK >> REPORT_HSWING_POS) + 1>(HSWING_CODES);
+
+    static constexpr uint8_t VSWING_CODES[vertical_swing_options::COUNT] = {
+        REPORT_VSWING_OFF, REPORT_VSWING_FULL, REPORT_VSWING_DOWN, REPORT_VSWING_MIDD, REPORT_VSWING_MID, REPORT_VSWING_MIDU,
+        REPORT_VSWING_UP, REPORT_VSWING_CDOWN, REPORT_VSWING_CMIDD, REPORT_VSWING_CMID, REPORT_VSWING_CMIDU, REPORT_VSWING_CUP,
+    };
+    static constexpr auto VSWING_OPTIONS = invert_codes<(REPORT_VSWING_MASK >> REPORT_VSWING_POS) + 1>(VSWING_CODES);
+
+    /* display OFF has no mode of its own, it is represented by REPORT_DISP_ON bit */
+    static constexpr uint8_t DISP_MODE_CODES[display_options::COUNT] = {
+        OPTION_INVALID, REPORT_DISP_MODE_AUTO, REPORT_DISP_MODE_SET, REPORT_DISP_MODE_ACT, REPORT_DISP_MODE_OUT,
+    };
+    static constexpr auto DISP_MODE_OPTIONS = invert_codes<(REPORT_DISP_MODE_MASK >> REPORT_DISP_MODE_POS) + 1>(DISP_MODE_CODES);
+
+    static const uint8_t REPORT_DISP_F_BYTE    = 7;
+    static const uint8_t REPORT_DISP_F_MASK    = 0b10000000;
+
+    static const uint8_t REPORT_PLASMA1_BYTE   = 6;
+    static const uint8_t REPORT_PLASMA1_MASK   = 0b00000100;
+    static const uint8_t REPORT_PLASMA2_BYTE   = 0;
+    static const uint8_t REPORT_PLASMA2_MASK   = 0b00000100;
+
+    static const uint8_t REPORT_SLEEP_BYTE     = 4;
+    static const uint8_t REPORT_SLEEP_MASK     = 0b00001000;
+
+    static const uint8_t REPORT_XFAN_BYTE      = 6;
+    static const uint8_t REPORT_XFAN_MASK      = 0b00001000;
+
+    static const uint8_t REPORT_SAVE_BYTE      = 11;
+    static const uint8_t REPORT_SAVE_MASK      = 0b01000000;
+
+    /* SET packet shares all the byte definition with REPORT */
+    static const uint8_t SET_PACKET_LEN        = 45;
+    static const uint8_t SET_FRAME_LEN         = SET_PACKET_LEN + 5; /* sync, length, command and checksum around the payload */
+    static const uint8_t SET_FRAME_PAYLOAD     = 4;                  /* payload offset in the frame */
+    static const uint8_t SET_FRAME_CHECKSUM    = SET_FRAME_LEN - 1;
+    
+    static const uint8_t SET_CONST_02_BYTE     = 39;
+    static const uint8_t SET_CONST_02_VAL      = 0x02;
+
+    static const uint8_t SET_AF_BYTE           = 3;
+    static const uint8_t SET_AF_VAL            = 0xAF;
+
+    static const uint8_t SET_NOCHANGE_BYTE     = 11;
+    static const uint8_t SET_NOCHANGE_MASK     = 0b00001000;
+
+    static const uint8_t SET_CONST_BIT_BYTE    = 7;
+    static const uint8_t SET_CONST_BIT_MASK    = 0b00000010;
+
+    /* sanity bounds of LEN byte (CMD + payload + checksum) for frames from AC */
+    static const uint8_t REPORT_LEN_MIN        = REPORT_TEMP_ACT_BYTE + 3; /* decoder needs payload up to REPORT_TEMP_ACT_BYTE */
+    static const uint8_t REPORT_LEN_MAX        = 0x40; /* leave some margin for models with longer reports */
+    static const uint8_t REPORT_PAYLOAD_MIN    = REPORT_LEN_MIN - 2; /* without CMD and checksum */
+
+    /* time constraints */
+    static const unsigned long TIME_REFRESH_PERIOD_MS   =  300; /* defaults of refresh scheduler, see refresh_due() */
+    static const unsigned long TIME_REFRESH_IDLE_MS     =  500;
+    static const unsigned long TIME_REFRESH_INIT_MAX_MS = 5000;
+    static const unsigned long TIME_TIMEOUT_INACTIVE_MS = 1000; /* lower bound, see inactive_timeout() */
+
+    /* UART runs at 4800 baud 8E1 - 11 bits on the wire per byte */
+    static const uint32_t UART_BYTE_TIME_US = 11 * 1000000UL / 4800;
+
+    constexpr uint32_t airtime_ms(uint32_t bytes) { return (bytes * UART_BYTE_TIME_US + 999) / 1000; }
+
+    static const unsigned long TIME_SET_AIRTIME_MS      = airtime_ms(SET_FRAME_LEN);              /* ~115 ms */
+    static const unsigned long TIME_REPORT_AIRTIME_MS   = airtime_ms(REPORT_LEN_MAX + 3);         /* longest report we accept */
+    static const unsigned long TIME_RESPONSE_MIN_MS     = TIME_SET_AIRTIME_MS + TIME_REPORT_AIRTIME_MS;
+    static const unsigned long TIME_UPDATE_COALESCE_MS  =   50; /* default, see set_update_coalesce_window() */
+    static const unsigned long TIME_RETRY_BACKOFF_MS    =  300; /* doubled with every retry of an update not applied by AC */
+    static const uint8_t       UPDATE_RETRIES_MAX       =    3;
+}
+
+/* Handler of a packet type recieved from AC, the component maps it to its handler method */
+enum class PacketHandler : uint8_t {
+    NONE,         /* known, but not processed */
+    UNIT_REPORT,
+    COUNT
+};
+
+/* Describes packet type recieved from AC, see packet_type() */
+typedef struct {
+    uint8_t cmd;
+    uint8_t len_min;  /* sanity bounds of LEN byte (CMD + payload + checksum), 0 - unknown packet */
+    uint8_t len_max;
+    PacketHandler handler;
+} PacketType_t;
+
+const PacketType_t &packet_type(uint8_t cmd);
+bool is_valid_header(uint8_t len, uint8_t cmd);
+
+/* Fields of a unit report that carried a code with no known meaning, defaults are decoded for them */
+namespace report_unknown{
+    enum : uint8_t {
+        MODE                = 1 << 0,
+        FAN_MODE            = 1 << 1,
+        VERTICAL_SWING      = 1 << 2,
+        HORIZONTAL_SWING    = 1 << 3,
+        DISPLAY_MODE        = 1 << 4,
+    };
+}
+
+/* Unit report decoded to plain values */
+typedef struct {
+    bool power;
+    uint8_t mode;                /* REPORT_MODE_*, not valid when report_unknown::MODE is set */
+    uint8_t target_temperature;
+    float current_temperature;
+    bool display_power;
+    ACSettings_t settings;       /* display is OFF when display_power is not set, display_mode is always the reported one */
+    uint8_t unknown;             /* report_unknown */
+} UnitReport_t;
+
+/* payload is the frame without header and checksum, SET payload shares the layout, so it can be decoded the same way.
+   Returns false and leaves report untouched if payload is shorter than REPORT_PAYLOAD_MIN */
+bool decode_unit_report(const FrameView &payload, UnitReport_t &report);
+/* update flags of SET payload, see SetFrame::encode_update(), both are false if payload is shorter than SET_PACKET_LEN */
+void decode_set_update(const FrameView &payload, bool &start, bool &apply);
+
+/* SET frame is built once and then only patched, every patch keeps the checksum valid.
+   Unit report shares the layout, so AC side can be built the same way when simulating it on a host */
+class SetFrame {
+    public:
+        void init(uint8_t cmd = protocol::CMD_OUT_PARAMS_SET);
+
+        /* start - 0xAF marking start of an update, apply - AC is to apply the settings */
+        void encode_update(bool start, bool apply);
+        void encode_mode(uint8_t mode, bool power);
+        void encode_target_temperature(uint8_t temperature);
+        /* out of range option indexes are encoded as the default option (AUTO / OFF) */
+        void encode_fan_mode(uint8_t fan_mode);
+        void encode_vertical_swing(uint8_t vertical_swing);
+        void encode_horizontal_swing(uint8_t horizontal_swing);
+        /* returns if display is encoded as powered on */
+        bool encode_display(uint8_t display, uint8_t display_mode);
+        /* display unit, plasma, sleep, xfan, save */
+        void encode_flags(const ACSettings_t &settings);
+        /* unit report only, AC ignores it in SET - clamped to the range of the field */
+        void encode_current_temperature(float temperature);
+
+        const uint8_t *data() const { return this->frame_.data(); }
+        size_t size() const { return this->frame_.size(); }
+
+    protected:
+        std::array<uint8_t, protocol::SET_FRAME_LEN> frame_;
+
+        void set_bits(uint8_t byte, uint8_t mask, uint8_t value);
+};
+
+}  // namespace CNT
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "esphome/components/button/button.h"
+#include "esphome/core/component.h"
+
+#include "esppac.h"
+
+namespace esphome {
+namespace sinclair_ac {
+
+/* Logs frames captured by the AC it belongs to, see SinclairAC::dump_capture() */
+class SinclairACButton : public button::Button, public Component {
+    public:
+        void set_parent(SinclairAC *parent) { this->parent_ = parent; }
+
+    protected:
+        SinclairAC *parent_ = nullptr;
+
+        void press_action() override { this->parent_->dump_capture(); }
+};
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,132 @@
+// libFuzzer target of the protocol core - framing of arbitrary UART data, decoding of every frame it lets through
+// and parsing of logged hex text. Invariants of the component's assumptions are checked, see README.md (FUZZING)
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "esppac_core.h"
+
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+#define FUZZ_ASSERT(cond) \
+    do { \
+        if (!(cond)) \
+            abort(); \
+    } while (0)
+
+static bool header_check(void *, uint8_t len, uint8_t cmd)
+{
+    return is_valid_header(len, cmd);
+}
+
+/* frame handed over by serial_parse() is complete and consistent with its header */
+static void check_frame(const SerialFrame_t &frame)
+{
+    FUZZ_ASSERT(frame.data_cnt >= 5 && frame.data_cnt <= DATA_MAX);
+    FUZZ_ASSERT(frame.data[0] == protocol::SYNC && frame.data[1] == protocol::SYNC);
+    FUZZ_ASSERT(frame.data[2] + 3 == frame.data_cnt);
+    FUZZ_ASSERT(is_valid_header(frame.data[2], frame.data[3]));
+
+    uint8_t checksum = 0;
+    for (uint8_t i = 2; i < frame.data_cnt - 1; i++)
+    {
+        checksum += frame.data[i];
+    }
+    FUZZ_ASSERT(checksum == frame.data[frame.data_cnt - 1]);
+
+    /* same way as the component hands the payload to the handlers */
+    FrameView payload = {frame.data + 4, (uint8_t) (frame.data_cnt - 5)};
+    const PacketType_t &type = packet_type(frame.data[3]);
+    if (type.handler == PacketHandler::UNIT_REPORT)
+    {
+        UnitReport_t report;
+        if (decode_unit_report(payload, report))
+        {
+            FUZZ_ASSERT(report.settings.fan_mode < fan_modes::COUNT);
+            FUZZ_ASSERT(report.settings.vertical_swing < vertical_swing_options::COUNT);
+            FUZZ_ASSERT(report.settings.horizontal_swing < horizontal_swing_options::COUNT);
+            FUZZ_ASSERT(report.settings.display < display_options::COUNT);
+        }
+    }
+    if (frame.data[3] == protocol::CMD_OUT_PARAMS_SET)
+    {
+        bool start, apply;
+        decode_set_update(payload, start, apply);
+    }
+}
+
+/* First byte chooses how the rest is chunked - the component reads whatever UART has, up to 64 bytes,
+   and gives up partial frames when no more data comes */
+static void fuzz_framing(const uint8_t *data, size_t size)
+{
+    if (size < 1)
+        return;
+    uint8_t chunk_max = (data[0] & 0x3F) + 1;
+    bool timeouts = data[0] & 0x40;
+    bool keep_pending = data[0] & 0x80;  /* frames not handled right away, slots get overwritten */
+    data++;
+    size--;
+
+    SerialProcess_t process = {};
+    uint32_t frames = 0;
+    for (size_t pos = 0; pos < size;)
+    {
+        size_t len = std::min(size - pos, (size_t) chunk_max);
+        size_t end = pos + len;
+        while (pos < end)
+        {
+            FrameEvent event;
+            size_t used = serial_parse(process, data + pos, end - pos, header_check, nullptr, event);
+            FUZZ_ASSERT(used > 0 && used <= end - pos);
+            pos += used;
+            if (event == FrameEvent::FRAME)
+            {
+                FUZZ_ASSERT(process.pending != nullptr);
+                check_frame(*process.pending);
+                frames++;
+                if (!keep_pending)
+                    process.pending = nullptr;
+            }
+            FUZZ_ASSERT(process.fill_slot < RX_SLOTS);
+            FUZZ_ASSERT(process.pending != &process.slot[process.fill_slot]);
+        }
+        if (timeouts && process.state == STATE_RECIEVE && (data[end - 1] & 1))
+            serial_timeout(process);
+    }
+    FUZZ_ASSERT(process.dropped_cnt <= frames);
+}
+
+/* reports as they come out of a buffer of any length, decoders must stay within payload */
+static void fuzz_decode(const uint8_t *data, size_t size)
+{
+    FrameView payload = {data, (uint8_t) std::min(size, (size_t) 255)};
+    UnitReport_t report;
+    decode_unit_report(payload, report);
+    bool start, apply;
+    decode_set_update(payload, start, apply);
+}
+
+static void fuzz_parse_hex(const uint8_t *data, size_t size)
+{
+    char text[512];
+    size_t len = std::min(size, sizeof(text) - 1);
+    memcpy(text, data, len);
+    text[len] = '\0';
+
+    uint8_t bytes[DATA_MAX];
+    size_t max = len % (DATA_MAX + 1);
+    FUZZ_ASSERT(parse_hex(text, bytes, max) <= max);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    /* decoders only see the exact payload length, a copy lets ASan catch reads past it */
+    uint8_t *copy = (uint8_t *) malloc(size == 0 ? 1 : size);
+    memcpy(copy, data, size);
+    fuzz_framing(copy, size);
+    fuzz_decode(copy, size);
+    fuzz_parse_hex(copy, size);
+    free(copy);
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Driver for fuzz targets where libFuzzer is not available (GCC) - runs the corpus, then a fixed number of
+// deterministic mutations of it. Takes the libFuzzer options it needs: -runs=N -seed=N -max_len=N, files or dirs
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+typedef std::vector<uint8_t> Input_t;
+
+static bool read_input(const std::string &path, Input_t &input)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+    uint8_t buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+    {
+        input.insert(input.end(), buf, buf + len);
+    }
+    fclose(file);
+    return true;
+}
+
+static void load_corpus(const std::string &path, std::vector<Input_t> &corpus)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        fprintf(stderr, "%s: not found\n", path.c_str());
+        exit(2);
+    }
+    if (!S_ISDIR(st.st_mode))
+    {
+        Input_t input;
+        if (read_input(path, input))
+            corpus.push_back(input);
+        return;
+    }
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr)
+        return;
+    std::vector<std::string> names;
+    while (struct dirent *entry = readdir(dir))
+    {
+        if (entry->d_name[0] != '.')
+            names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    /* readdir order is not stable, mutations depend on the corpus order */
+    std::sort(names.begin(), names.end());
+    for (const std::string &name : names)
+    {
+        load_corpus(path + "/" + name, corpus);
+    }
+}
+
+/* byte level mutations in the spirit of libFuzzer's, plus sync bytes the framing is sensitive to */
+static void mutate(Input_t &input, const std::vector<Input_t> &corpus, std::mt19937 &rng, size_t max_len)
+{
+    size_t count = 1 + rng() % 4;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t pos = input.empty() ? 0 : rng() % (input.size() + 1);
+        switch (rng() % 7)
+        {
+            case 0:
+                if (pos < input.size())
+                    input[pos] ^= 1 << (rng() % 8);
+                break;
+            case 1:
+                if (pos < input.size())
+                    input[pos] = rng();
+                break;
+            case 2:
+                input.insert(input.begin() + pos, (uint8_t) rng());
+                break;
+            case 3:
+                if (pos < input.size())
+                    input.erase(input.begin() + pos, input.begin() + std::min(input.size(), pos + 1 + rng() % 8));
+                break;
+            case 4:
+                input.insert(input.begin() + pos, {0x7E, 0x7E});
+                break;
+            case 5:
+            {
+                /* part of another input spliced in */
+                const Input_t &other = corpus[rng() % corpus.size()];
+                if (other.empty())
+                    break;
+                size_t from = rng() % other.size();
+                size_t len = 1 + rng() % (other.size() - from);
+                input.insert(input.begin() + pos, other.begin() + from, other.begin() + from + len);
+                break;
+            }
+            case 6:
+                if (pos < input.size())
+                    input[pos] = (uint8_t) (input[pos] + 1 - 2 * (rng() % 2));
+                break;
+        }
+    }
+    if (input.size() > max_len)
+        input.resize(max_len);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long runs = 10000;
+    unsigned long seed = 1;
+    size_t max_len = 1024;
+    std::vector<Input_t> corpus;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "-runs=", 6) == 0)
+            runs = strtoul(argv[i] + 6, nullptr, 10);
+        else if (strncmp(argv[i], "-seed=", 6) == 0)
+            seed = strtoul(argv[i] + 6, nullptr, 10);
+        else if (strncmp(argv[i], "-max_len=", 9) == 0)
+            max_len = strtoul(argv[i] + 9, nullptr, 10);
+        else if (argv[i][0] == '-')
+            fprintf(stderr, "ignoring %s\n", argv[i]);
+        else
+            load_corpus(argv[i], corpus);
+    }
+    if (corpus.empty())
+        corpus.push_back(Input_t());
+
+    for (const Input_t &input : corpus)
+    {
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+
+    std::mt19937 rng(seed);
+    Input_t input;
+    for (unsigned long run = 0; run < runs; run++)
+    {
+        /* mostly keep mutating the last input, sometimes start over from the corpus */
+        if (run % 16 == 0 || input.empty())
+            input = corpus[rng() % corpus.size()];
+        mutate(input, corpus, rng, max_len);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    printf("Done %lu runs of %zu corpus inputs, seed %lu\n", runs, corpus.size(), seed);
+    return 0;
+}
@@ -0,0 +1,51 @@
+// UART of the host build - recieved bytes are queued by the caller, written bytes are collected for it
+#pragma once
+
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "esphome/components/uart/uart.h"
+
+namespace host {
+
+class BufferUART : public esphome::uart::UARTComponent {
+    public:
+        /* bytes the device is going to recieve */
+        void feed(const uint8_t *data, size_t len) { this->rx_.insert(this->rx_.end(), data, data + len); }
+        /* bytes the device has written since the last call */
+        std::vector<uint8_t> take_tx()
+        {
+            std::vector<uint8_t> tx;
+            tx.swap(this->tx_);
+            return tx;
+        }
+
+        void write_array(const uint8_t *data, size_t len) override { this->tx_.insert(this->tx_.end(), data, data + len); }
+
+        bool peek_byte(uint8_t *data) override
+        {
+            if (this->rx_.empty())
+                return false;
+            *data = this->rx_.front();
+            return true;
+        }
+
+        bool read_array(uint8_t *data, size_t len) override
+        {
+            if (this->rx_.size() < len)
+                return false;
+            std::copy(this->rx_.begin(), this->rx_.begin() + len, data);
+            this->rx_.erase(this->rx_.begin(), this->rx_.begin() + len);
+            return true;
+        }
+
+        int available() override { return this->rx_.size(); }
+        void flush() override {}
+
+    protected:
+        std::deque<uint8_t> rx_;
+        std::vector<uint8_t> tx_;
+};
+
+}  // namespace host
@@ -0,0 +1,27 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace button {
+
+class Button : public EntityBase {
+    public:
+        void press()
+        {
+            this->press_action();
+            this->press_callback_.call();
+        }
+
+        void add_on_press_callback(std::function<void()> &&callback) { this->press_callback_.add(std::move(callback)); }
+
+    protected:
+        virtual void press_action() = 0;
+
+        CallbackManager<void()> press_callback_;
+};
+
+}  // namespace button
+}  // namespace esphome
@@ -0,0 +1,106 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <set>
+#include <string>
+
+#include "esphome/components/climate/climate_mode.h"
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace climate {
+
+class ClimateTraits {
+    public:
+        void set_supports_action(bool supports) { this->supports_action_ = supports; }
+        void set_supports_current_temperature(bool supports) { this->supports_current_temperature_ = supports; }
+        void set_supports_two_point_target_temperature(bool supports) { this->supports_two_point_ = supports; }
+        void set_visual_min_temperature(float temperature) { this->visual_min_temperature_ = temperature; }
+        void set_visual_max_temperature(float temperature) { this->visual_max_temperature_ = temperature; }
+        void set_visual_temperature_step(float step) { this->visual_temperature_step_ = step; }
+        void set_supported_modes(std::set<ClimateMode> modes) { this->supported_modes_ = std::move(modes); }
+        void add_supported_custom_fan_mode(const std::string &mode) { this->supported_custom_fan_modes_.insert(mode); }
+        void set_supported_swing_modes(std::set<ClimateSwingMode> modes) { this->supported_swing_modes_ = std::move(modes); }
+
+        bool supports_mode(ClimateMode mode) const { return this->supported_modes_.count(mode); }
+        bool supports_custom_fan_mode(const std::string &mode) const { return this->supported_custom_fan_modes_.count(mode); }
+        bool supports_swing_mode(ClimateSwingMode mode) const { return this->supported_swing_modes_.count(mode); }
+
+    protected:
+        bool supports_action_ = false;
+        bool supports_current_temperature_ = false;
+        bool supports_two_point_ = false;
+        float visual_min_temperature_ = 10;
+        float visual_max_temperature_ = 30;
+        float visual_temperature_step_ = 0.1;
+        std::set<ClimateMode> supported_modes_;
+        std::set<std::string> supported_custom_fan_modes_;
+        std::set<ClimateSwingMode> supported_swing_modes_;
+};
+
+class Climate;
+
+/* Values not set by the caller are empty, perform() drops the ones not supported by traits and hands the rest to control() */
+class ClimateCall {
+    public:
+        explicit ClimateCall(Climate *parent) : parent_(parent) {}
+
+        ClimateCall &set_mode(ClimateMode mode) { this->mode_ = mode; return *this; }
+        ClimateCall &set_target_temperature(float temperature) { this->target_temperature_ = temperature; return *this; }
+        ClimateCall &set_fan_mode(const std::string &fan_mode) { this->custom_fan_mode_ = fan_mode; return *this; }
+        ClimateCall &set_swing_mode(ClimateSwingMode swing_mode) { this->swing_mode_ = swing_mode; return *this; }
+        void perform();
+
+        const optional<ClimateMode> &get_mode() const { return this->mode_; }
+        const optional<float> &get_target_temperature() const { return this->target_temperature_; }
+        const optional<std::string> &get_custom_fan_mode() const { return this->custom_fan_mode_; }
+        const optional<ClimateSwingMode> &get_swing_mode() const { return this->swing_mode_; }
+
+    protected:
+        Climate *parent_;
+        optional<ClimateMode> mode_;
+        optional<float> target_temperature_;
+        optional<std::string> custom_fan_mode_;
+        optional<ClimateSwingMode> swing_mode_;
+};
+
+class Climate : public EntityBase {
+    public:
+        ClimateMode mode = CLIMATE_MODE_OFF;
+        ClimateAction action = CLIMATE_ACTION_OFF;
+        float current_temperature = NAN;
+        float target_temperature = NAN;
+        optional<std::string> custom_fan_mode;
+        ClimateSwingMode swing_mode = CLIMATE_SWING_OFF;
+
+        ClimateCall make_call() { return ClimateCall(this); }
+
+        void add_on_state_callback(std::function<void(Climate &)> &&callback) { this->state_callback_.add(std::move(callback)); }
+        void publish_state() { this->state_callback_.call(*this); }
+
+        ClimateTraits get_traits() { return this->traits(); }
+
+    protected:
+        friend ClimateCall;
+
+        virtual ClimateTraits traits() = 0;
+        virtual void control(const ClimateCall &call) = 0;
+
+        CallbackManager<void(Climate &)> state_callback_;
+};
+
+inline void ClimateCall::perform()
+{
+    ClimateTraits traits = this->parent_->get_traits();
+    if (this->mode_.has_value() && !traits.supports_mode(*this->mode_))
+        this->mode_.reset();
+    if (this->custom_fan_mode_.has_value() && !traits.supports_custom_fan_mode(*this->custom_fan_mode_))
+        this->custom_fan_mode_.reset();
+    if (this->swing_mode_.has_value() && !traits.supports_swing_mode(*this->swing_mode_))
+        this->swing_mode_.reset();
+    this->parent_->control(*this);
+}
+
+}  // namespace climate
+}  // namespace esphome
@@ -0,0 +1,36 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace climate {
+
+enum ClimateMode : uint8_t {
+    CLIMATE_MODE_OFF = 0,
+    CLIMATE_MODE_HEAT_COOL = 1,
+    CLIMATE_MODE_COOL = 2,
+    CLIMATE_MODE_HEAT = 3,
+    CLIMATE_MODE_FAN_ONLY = 4,
+    CLIMATE_MODE_DRY = 5,
+    CLIMATE_MODE_AUTO = 6,
+};
+
+enum ClimateAction : uint8_t {
+    CLIMATE_ACTION_OFF = 0,
+    CLIMATE_ACTION_COOLING = 2,
+    CLIMATE_ACTION_HEATING = 3,
+    CLIMATE_ACTION_IDLE = 4,
+    CLIMATE_ACTION_DRYING = 5,
+    CLIMATE_ACTION_FAN = 6,
+};
+
+enum ClimateSwingMode : uint8_t {
+    CLIMATE_SWING_OFF = 0,
+    CLIMATE_SWING_BOTH = 1,
+    CLIMATE_SWING_VERTICAL = 2,
+    CLIMATE_SWING_HORIZONTAL = 3,
+};
+
+}  // namespace climate
+}  // namespace esphome
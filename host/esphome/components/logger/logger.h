@@ -0,0 +1,33 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "esphome/core/component.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace logger {
+
+/* Runtime log levels - global one and per tag overrides, lines above them are not printed */
+class Logger : public Component {
+    public:
+        void set_log_level(int level) { this->current_level_ = level; }
+        void set_log_level(const std::string &tag, int level) { this->log_levels_[tag] = level; }
+
+        int level_for(const char *tag)
+        {
+            auto it = this->log_levels_.find(tag);
+            return it != this->log_levels_.end() ? it->second : this->current_level_;
+        }
+
+    protected:
+        int current_level_ = ESPHOME_LOG_LEVEL_DEBUG;
+        std::map<std::string, int> log_levels_;
+};
+
+extern Logger *global_logger;
+
+}  // namespace logger
+}  // namespace esphome
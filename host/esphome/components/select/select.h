@@ -0,0 +1,96 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace select {
+
+class SelectTraits {
+    public:
+        void set_options(std::vector<std::string> options) { this->options_ = std::move(options); }
+        const std::vector<std::string> &get_options() const { return this->options_; }
+
+    protected:
+        std::vector<std::string> options_;
+};
+
+class Select;
+
+class SelectCall {
+    public:
+        explicit SelectCall(Select *parent) : parent_(parent) {}
+
+        SelectCall &set_option(const std::string &option) { this->option_ = option; return *this; }
+        void perform();
+
+    protected:
+        Select *parent_;
+        optional<std::string> option_;
+};
+
+class Select : public EntityBase {
+    public:
+        std::string state;
+        SelectTraits traits;
+
+        /* as in ESPHome - state is stored and callbacks run only for options from traits */
+        void publish_state(const std::string &state)
+        {
+            auto index = this->index_of(state);
+            if (!index.has_value())
+            {
+                ESP_LOGE("select", "'%s': invalid state for publish_state(): %s", this->name_.c_str(), state.c_str());
+                return;
+            }
+            this->has_state_ = true;
+            this->state = state;
+            this->state_callback_.call(state, *index);
+        }
+
+        bool has_state() const { return this->has_state_; }
+
+        optional<size_t> index_of(const std::string &option) const
+        {
+            const auto &options = this->traits.get_options();
+            for (size_t i = 0; i < options.size(); i++)
+            {
+                if (options[i] == option)
+                    return i;
+            }
+            return {};
+        }
+
+        SelectCall make_call() { return SelectCall(this); }
+
+        void add_on_state_callback(std::function<void(std::string, size_t)> &&callback)
+        {
+            this->state_callback_.add(std::move(callback));
+        }
+
+    protected:
+        friend SelectCall;
+
+        /* user requested the option, the implementation is to publish the state it ends up in */
+        virtual void control(const std::string &value) = 0;
+
+        bool has_state_ = false;
+        CallbackManager<void(std::string, size_t)> state_callback_;
+};
+
+inline void SelectCall::perform()
+{
+    if (!this->option_.has_value() || !this->parent_->index_of(*this->option_).has_value())
+    {
+        ESP_LOGW("select", "'%s': invalid option", this->parent_->get_name().c_str());
+        return;
+    }
+    this->parent_->control(*this->option_);
+}
+
+}  // namespace select
+}  // namespace esphome
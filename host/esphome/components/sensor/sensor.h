@@ -0,0 +1,34 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <cmath>
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace sensor {
+
+/* no filters on host - published value is the state */
+class Sensor : public EntityBase {
+    public:
+        float state = NAN;
+
+        void publish_state(float state)
+        {
+            this->has_state_ = true;
+            this->state = state;
+            this->callback_.call(state);
+        }
+
+        bool has_state() const { return this->has_state_; }
+
+        void add_on_state_callback(std::function<void(float)> &&callback) { this->callback_.add(std::move(callback)); }
+
+    protected:
+        bool has_state_ = false;
+        CallbackManager<void(float)> callback_;
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -0,0 +1,41 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace switch_ {
+
+class Switch : public EntityBase {
+    public:
+        bool state = false;
+
+        /* as in ESPHome - publishing the state the switch already has is ignored */
+        void publish_state(bool state)
+        {
+            if (this->has_state_ && this->state == state)
+                return;
+            this->has_state_ = true;
+            this->state = state;
+            this->state_callback_.call(state);
+        }
+
+        bool has_state() const { return this->has_state_; }
+
+        void turn_on() { this->write_state(true); }
+        void turn_off() { this->write_state(false); }
+        void toggle() { this->write_state(!this->state); }
+
+        void add_on_state_callback(std::function<void(bool)> &&callback) { this->state_callback_.add(std::move(callback)); }
+
+    protected:
+        /* user requested the state, the implementation is to publish the state it ends up in */
+        virtual void write_state(bool state) = 0;
+
+        bool has_state_ = false;
+        CallbackManager<void(bool)> state_callback_;
+};
+
+}  // namespace switch_
+}  // namespace esphome
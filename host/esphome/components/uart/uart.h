@@ -0,0 +1,47 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace uart {
+
+/* UART bus, host implementations decide where the bytes come from and go to */
+class UARTComponent {
+    public:
+        virtual ~UARTComponent() = default;
+
+        virtual void write_array(const uint8_t *data, size_t len) = 0;
+        virtual bool peek_byte(uint8_t *data) = 0;
+        virtual bool read_array(uint8_t *data, size_t len) = 0;
+        virtual int available() = 0;
+        virtual void flush() = 0;
+};
+
+class UARTDevice {
+    public:
+        UARTDevice() = default;
+        explicit UARTDevice(UARTComponent *parent) : parent_(parent) {}
+
+        void set_uart_parent(UARTComponent *parent) { this->parent_ = parent; }
+
+        void write_byte(uint8_t data) { this->parent_->write_array(&data, 1); }
+        void write_array(const uint8_t *data, size_t len) { this->parent_->write_array(data, len); }
+        void write_array(const std::vector<uint8_t> &data) { this->parent_->write_array(data.data(), data.size()); }
+
+        bool read_byte(uint8_t *data) { return this->parent_->read_array(data, 1); }
+        bool peek_byte(uint8_t *data) { return this->parent_->peek_byte(data); }
+        bool read_array(uint8_t *data, size_t len) { return this->parent_->read_array(data, len); }
+        int available() { return this->parent_->available(); }
+        void flush() { this->parent_->flush(); }
+
+    protected:
+        UARTComponent *parent_ = nullptr;
+};
+
+}  // namespace uart
+}  // namespace esphome
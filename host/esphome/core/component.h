@@ -0,0 +1,51 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <string>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+
+namespace setup_priority {
+static const float DATA = 600.0f;
+static const float LATE = -100.0f;
+}  // namespace setup_priority
+
+/* Host has no scheduler - set_interval()/set_timeout() are accepted and never fire,
+   everything the host builds test is driven from loop() */
+class Component {
+    public:
+        virtual ~Component() = default;
+
+        virtual void setup() {}
+        virtual void loop() {}
+        virtual void dump_config() {}
+        virtual float get_setup_priority() const { return 0.0f; }
+
+        bool status_has_error() const { return this->error_; }
+        void status_set_error(const char *message = nullptr) { this->error_ = true; }
+        void status_clear_error() { this->error_ = false; }
+
+    protected:
+        void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {}
+        void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {}
+        bool cancel_interval(const std::string &name) { return false; }
+        bool cancel_timeout(const std::string &name) { return false; }
+
+        bool error_ = false;
+};
+
+/* Name shared by all entities */
+class EntityBase {
+    public:
+        const std::string &get_name() const { return this->name_; }
+        void set_name(const std::string &name) { this->name_ = name; }
+
+    protected:
+        std::string name_;
+};
+
+}  // namespace esphome
@@ -0,0 +1,5 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#define USE_LOGGER
+#define USE_SINCLAIR_AC_CAPTURE
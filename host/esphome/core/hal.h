@@ -0,0 +1,12 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+/* monotonic time since start of the process */
+uint32_t millis();
+uint32_t micros();
+
+}  // namespace esphome
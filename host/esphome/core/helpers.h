@@ -0,0 +1,38 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+
+template<typename T> using optional = std::optional<T>;
+
+template<typename... X> class CallbackManager;
+
+template<typename... Ts> class CallbackManager<void(Ts...)> {
+    public:
+        void add(std::function<void(Ts...)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+        void call(Ts... args)
+        {
+            for (auto &cb : this->callbacks_)
+            {
+                cb(args...);
+            }
+        }
+
+    protected:
+        std::vector<std::function<void(Ts...)>> callbacks_;
+};
+
+/* Same output as ESPHome - "7E.7E.31 (3)" style, length suffix only for more than 4 bytes */
+std::string format_hex_pretty(const uint8_t *data, size_t length);
+std::string format_hex_pretty(const std::vector<uint8_t> &data);
+
+}  // namespace esphome
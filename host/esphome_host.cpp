@@ -0,0 +1,82 @@
+// Host build of ESPHome API used by the sinclair_ac component - see host/README.md
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+
+#include "esphome/components/logger/logger.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "virtual_clock.h"
+
+namespace esphome {
+
+static const auto START = std::chrono::steady_clock::now();
+
+uint32_t millis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - START).count();
+}
+
+uint32_t micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - START).count();
+}
+
+static char format_hex_pretty_char(uint8_t v)
+{
+    return v >= 10 ? 'A' + (v - 10) : '0' + v;
+}
+
+std::string format_hex_pretty(const uint8_t *data, size_t length)
+{
+    if (data == nullptr || length == 0)
+        return "";
+    std::string ret;
+    ret.resize(3 * length - 1);
+    for (size_t i = 0; i < length; i++)
+    {
+        ret[3 * i] = format_hex_pretty_char((data[i] & 0xF0) >> 4);
+        ret[3 * i + 1] = format_hex_pretty_char(data[i] & 0x0F);
+        if (i != length - 1)
+            ret[3 * i + 2] = '.';
+    }
+    if (length > 4)
+        return ret + " (" + std::to_string(length) + ")";
+    return ret;
+}
+
+std::string format_hex_pretty(const std::vector<uint8_t> &data)
+{
+    return format_hex_pretty(data.data(), data.size());
+}
+
+namespace logger {
+
+static Logger default_logger;
+Logger *global_logger = &default_logger;
+
+}  // namespace logger
+
+void esp_log_printf_(int level, const char *tag, int line, const char *format, ...)
+{
+    static const char LETTERS[] = "NEWICDVV";
+
+    if (logger::global_logger == nullptr || level > logger::global_logger->level_for(tag))
+        return;
+
+    char buf[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    fprintf(stderr, "[%c][%s:%03d]: %s\n", LETTERS[level & 7], tag, line, buf);
+}
+
+}  // namespace esphome
+
+namespace host {
+
+uint32_t virtual_millis = 0;
+
+}  // namespace host
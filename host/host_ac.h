@@ -0,0 +1,89 @@
+// SinclairACCNT wired to host entities, a buffered UART and the virtual clock, as ESPHome would wire it
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer_uart.h"
+#include "esppac_cnt.h"
+#include "sinclair_ac_select.h"
+#include "sinclair_ac_switch.h"
+#include "virtual_clock.h"
+
+namespace host {
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+
+template<size_t N> std::vector<std::string> options(const char *const (&names)[N])
+{
+    return std::vector<std::string>(names, names + N);
+}
+
+/* protected state of the component is exposed to the tests */
+class HostAC : public CNT::SinclairACCNT {
+    public:
+        using SinclairACCNT::state_;
+        using SinclairACCNT::update_;
+        using SinclairACCNT::settings_;
+        using SinclairACCNT::confirm_pending_;
+        using SinclairACCNT::inactive_timeout;
+        using SinclairACCNT::serialProcess_;
+        using SinclairACCNT::mode_internal_;
+        using SinclairACCNT::wait_response_;
+        using SinclairACCNT::send_packet;
+
+        BufferUART uart;
+
+        SinclairACSelect vertical_swing;
+        SinclairACSelect horizontal_swing;
+        SinclairACSelect display;
+        SinclairACSelect display_unit;
+
+        SinclairACSwitch plasma;
+        SinclairACSwitch sleep;
+        SinclairACSwitch xfan;
+        SinclairACSwitch save;
+
+        sensor::Sensor apply_latency;
+        sensor::Sensor apply_retries;
+
+        HostAC()
+        {
+            this->set_uart_parent(&this->uart);
+            this->set_clock(&virtual_clock);
+
+            this->set_name("climate");
+            this->vertical_swing.set_name("vertical_swing");
+            this->horizontal_swing.set_name("horizontal_swing");
+            this->display.set_name("display");
+            this->display_unit.set_name("display_unit");
+            this->plasma.set_name("plasma");
+            this->sleep.set_name("sleep");
+            this->xfan.set_name("xfan");
+            this->save.set_name("save");
+            this->apply_latency.set_name("apply_latency");
+            this->apply_retries.set_name("apply_retries");
+
+            this->vertical_swing.traits.set_options(options(vertical_swing_options::NAMES));
+            this->horizontal_swing.traits.set_options(options(horizontal_swing_options::NAMES));
+            this->display.traits.set_options(options(display_options::NAMES));
+            this->display_unit.traits.set_options(options(display_unit_options::NAMES));
+            this->set_vertical_swing_select(&this->vertical_swing);
+            this->set_horizontal_swing_select(&this->horizontal_swing);
+            this->set_display_select(&this->display);
+            this->set_display_unit_select(&this->display_unit);
+
+            this->set_plasma_switch(&this->plasma);
+            this->set_sleep_switch(&this->sleep);
+            this->set_xfan_switch(&this->xfan);
+            this->set_save_switch(&this->save);
+
+            this->set_apply_latency_sensor(&this->apply_latency);
+            this->set_apply_retries_sensor(&this->apply_retries);
+        }
+
+        bool ready() const { return this->state_ == CNT::ACState::Ready; }
+};
+
+}  // namespace host
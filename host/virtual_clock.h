@@ -0,0 +1,15 @@
+// Simulated milliseconds for SinclairAC::set_clock() - time moves only when the caller advances it
+#pragma once
+
+#include <cstdint>
+
+namespace host {
+
+extern uint32_t virtual_millis;
+
+inline uint32_t virtual_clock()
+{
+    return virtual_millis;
+}
+
+}  // namespace host
@@ -0,0 +1,46 @@
+// Minimal checks for the host tests - failed checks are reported and make the test exit non-zero
+#pragma once
+
+#include <cstdio>
+
+namespace check {
+
+inline int &failures()
+{
+    static int cnt = 0;
+    return cnt;
+}
+
+/* return value of main() */
+inline int result()
+{
+    if (failures() > 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures());
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace check
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) \
+        { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            check::failures()++; \
+        } \
+    } while (0)
+
+/* integral values only, they are printed on failure */
+#define CHECK_EQ(a, b) \
+    do { \
+        long long a_ = (long long) (a); \
+        long long b_ = (long long) (b); \
+        if (a_ != b_) \
+        { \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, a_, b_); \
+            check::failures()++; \
+        } \
+    } while (0)
@@ -0,0 +1,247 @@
+// Heap use of the component in steady state - every operator new of the process is counted while enabled
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "check.h"
+#include "esphome/components/logger/logger.h"
+#include "host_ac.h"
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+static bool counting = false;
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    if (counting)
+        allocations++;
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    if (counting)
+        allocations++;
+    return malloc(size == 0 ? 1 : size);
+}
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+/* UART with fixed buffers - BufferUART would allocate by itself */
+class RingUART : public uart::UARTComponent {
+    public:
+        void feed(const uint8_t *data, size_t len)
+        {
+            for (size_t i = 0; i < len && this->cnt_ < sizeof(this->rx_); i++, this->cnt_++)
+            {
+                this->rx_[(this->head_ + this->cnt_) % sizeof(this->rx_)] = data[i];
+            }
+        }
+
+        void write_array(const uint8_t *data, size_t len) override { this->tx_bytes += len; }
+
+        bool peek_byte(uint8_t *data) override
+        {
+            if (this->cnt_ == 0)
+                return false;
+            *data = this->rx_[this->head_];
+            return true;
+        }
+
+        bool read_array(uint8_t *data, size_t len) override
+        {
+            if (this->cnt_ < len)
+                return false;
+            for (size_t i = 0; i < len; i++)
+            {
+                data[i] = this->rx_[this->head_];
+                this->head_ = (this->head_ + 1) % sizeof(this->rx_);
+            }
+            this->cnt_ -= len;
+            return true;
+        }
+
+        int available() override { return this->cnt_; }
+        void flush() override {}
+
+        size_t tx_bytes = 0;
+
+    protected:
+        uint8_t rx_[512];
+        size_t head_ = 0;
+        size_t cnt_ = 0;
+};
+
+/* unit report of tests/data/replay_sample.log - mode OFF */
+static const char *const REPORT_OFF =
+    "7E.7E.2F.31.00.00.00.00.10.80.02.02.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00."
+    "00.00.00.00.00.00.02.00.00.43.00.00.39";
+
+/* component keeps AC alive for given ms of virtual time, AC answers every frame after 50 ms */
+static void keep_alive(host::HostAC &ac, RingUART &uart, const uint8_t *report, size_t report_len, uint32_t ms)
+{
+    uint32_t answer_at = 0;
+    bool answer = false;
+    for (uint32_t end = host::virtual_millis + ms; host::virtual_millis < end;)
+    {
+        uint32_t now = ++host::virtual_millis;
+        if (answer && now >= answer_at)
+        {
+            uart.feed(report, report_len);
+            answer = false;
+        }
+        size_t tx_bytes = uart.tx_bytes;
+        ac.loop();
+        if (uart.tx_bytes != tx_bytes)
+        {
+            answer = true;
+            answer_at = now + 50;
+        }
+    }
+}
+
+/* logging below VERBOSE - RX and TX frames are not formatted, nothing is allocated */
+static void test_keep_alive_allocates_nothing()
+{
+    uint8_t report[DATA_MAX];
+    size_t report_len = parse_hex(REPORT_OFF, report, sizeof(report));
+
+    host::virtual_millis = 0;
+    host::HostAC ac;
+    RingUART uart;
+    ac.set_uart_parent(&uart);
+    ac.setup();
+
+    /* first reports are decoded and published */
+    logger::global_logger->set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+    keep_alive(ac, uart, report, report_len, 5000);
+    CHECK(ac.ready());
+
+    uint32_t rx_frames = ac.get_link_stats().rx_frames;
+    uint32_t tx_frames = ac.get_link_stats().tx_frames;
+    allocations = 0;
+    counting = true;
+    keep_alive(ac, uart, report, report_len, 10 * 60 * 1000);
+    counting = false;
+    CHECK_EQ(allocations, 0);
+    CHECK(ac.get_link_stats().rx_frames - rx_frames >= 1000);
+    CHECK(ac.get_link_stats().tx_frames - tx_frames >= 1000);
+    CHECK(ac.ready());
+
+    /* VERBOSE for the tag of the component only - the frames are formatted, which the count has to show */
+    logger::global_logger->set_log_level("sinclair_ac", ESPHOME_LOG_LEVEL_VERBOSE);
+    allocations = 0;
+    counting = true;
+    keep_alive(ac, uart, report, report_len, 1000);
+    counting = false;
+    CHECK(allocations > 0);
+    logger::global_logger->set_log_level("sinclair_ac", ESPHOME_LOG_LEVEL_DEBUG);
+}
+
+static const size_t CORRUPTED_EVERY = 13;
+
+/* Unit reports as AC sends them, target and room temperature changing from report to report, with line noise
+   between some of them and some of them corrupted */
+static std::vector<uint8_t> report_stream(size_t frames)
+{
+    std::vector<uint8_t> stream;
+    SetFrame report;
+    report.init(protocol::CMD_IN_UNIT_REPORT);
+    ACSettings_t settings = {};
+    settings.fan_mode = fan_modes::FAN_AUTO;
+    report.encode_mode(protocol::REPORT_MODE_COOL, true);
+    report.encode_fan_mode(settings.fan_mode);
+    report.encode_vertical_swing(vertical_swing_options::OFF);
+    report.encode_horizontal_swing(horizontal_swing_options::OFF);
+    report.encode_display(display_options::AUTO, display_options::AUTO);
+    report.encode_flags(settings);
+    for (size_t i = 0; i < frames; i++)
+    {
+        report.encode_target_temperature(16 + i % 15);
+        report.encode_current_temperature(20.0f + (i % 20) / 2.0f);
+        stream.insert(stream.end(), report.data(), report.data() + report.size());
+        if (i % CORRUPTED_EVERY == 0)
+        {
+            /* bit flipped on the wire */
+            stream[stream.size() - 10] ^= 0x04;
+        }
+        if (i % 7 == 0)
+        {
+            /* a broken start of a frame, a stray sync byte and garbage */
+            static const uint8_t NOISE[] = {0x7E, 0x7E, 0xF0, 0x7E, 0x13, 0x55};
+            stream.insert(stream.end(), NOISE, NOISE + sizeof(NOISE));
+        }
+    }
+    return stream;
+}
+
+/* the whole recieve path - UART reads, framing, resync, decoding and climate publishes - runs on fixed buffers */
+static void test_report_stream_allocates_nothing()
+{
+    static const size_t FRAMES = 20000;
+    std::vector<uint8_t> warm_up = report_stream(10);  /* the first one is corrupted */
+    std::vector<uint8_t> stream = report_stream(FRAMES);
+
+    host::virtual_millis = 0;
+    host::HostAC ac;
+    RingUART uart;
+    ac.set_uart_parent(&uart);
+    ac.setup();
+    logger::global_logger->set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+
+    uint32_t published = 0;
+    ac.add_on_state_callback([&](climate::Climate &climate) { published++; });
+
+    /* first reports make the component ready and publish every entity once */
+    for (size_t pos = 0; pos < warm_up.size(); pos += 16)
+    {
+        uart.feed(warm_up.data() + pos, std::min(warm_up.size() - pos, (size_t) 16));
+        host::virtual_millis += protocol::airtime_ms(16);
+        ac.loop();
+    }
+    CHECK(ac.ready());
+
+    uint32_t rx_frames = ac.get_link_stats().rx_frames;
+    uint32_t dropped = ac.get_dropped_frames();
+    uint32_t published_before = published;
+    allocations = 0;
+    counting = true;
+    /* pieces of varying length a loop() finds in UART, time passes as the bytes take at 4800 baud */
+    for (size_t pos = 0, i = 0; pos < stream.size(); i++)
+    {
+        size_t len = std::min(stream.size() - pos, (size_t) (1 + (i * 7) % 16));
+        uart.feed(stream.data() + pos, len);
+        pos += len;
+        host::virtual_millis += protocol::airtime_ms(len);
+        ac.loop();
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        host::virtual_millis += 5;
+        ac.loop();
+    }
+    counting = false;
+
+    CHECK_EQ(allocations, 0);
+    CHECK_EQ(ac.get_link_stats().rx_frames - rx_frames, FRAMES - (FRAMES + CORRUPTED_EVERY - 1) / CORRUPTED_EVERY);
+    CHECK_EQ(ac.get_dropped_frames(), dropped);
+    CHECK(ac.get_link_stats().resyncs > 0);
+    CHECK(published - published_before >= FRAMES / 2);
+}
+
+int main()
+{
+    test_keep_alive_allocates_nothing();
+    test_report_stream_allocates_nothing();
+    return check::result();
+}
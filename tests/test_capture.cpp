@@ -0,0 +1,117 @@
+// Frame capture of SinclairAC - per instance ring of last frames, including the ones dropped by framing
+#include <cstring>
+
+#include "check.h"
+#include "esphome/components/logger/logger.h"
+#include "host_ac.h"
+#include "sinclair_ac_button.h"
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+/* unit report of tests/data/replay_sample.log - mode OFF */
+static const char *const REPORT_OFF =
+    "7E.7E.2F.31.00.00.00.00.10.80.02.02.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00."
+    "00.00.00.00.00.00.02.00.00.43.00.00.39";
+
+static void feed(host::HostAC &ac, const uint8_t *data, size_t len)
+{
+    ac.uart.feed(data, len);
+    host::virtual_millis += protocol::airtime_ms(len);
+    ac.loop();
+    ac.uart.take_tx();
+}
+
+static bool same(const CaptureEntry_t *entry, const uint8_t *data, size_t len)
+{
+    return entry != nullptr && entry->len == len && memcmp(entry->data, data, len) == 0;
+}
+
+/* good and dropped frames are kept in order they came, with what was wrong with them */
+static void test_capture_errors()
+{
+    host::virtual_millis = 0;
+    host::HostAC ac;
+    ac.set_capture_frames(8);
+    ac.setup();
+
+    uint8_t report[DATA_MAX];
+    size_t report_len = parse_hex(REPORT_OFF, report, sizeof(report));
+    uint8_t broken[DATA_MAX];
+    memcpy(broken, report, report_len);
+    broken[10] ^= 0x04;
+    static const uint8_t TOO_LONG[] = {0x7E, 0x7E, 0xF0};
+    static const uint8_t WRONG_LEN[] = {0x7E, 0x7E, 0x05, 0x31};
+
+    feed(ac, report, report_len);
+    feed(ac, broken, report_len);
+    feed(ac, TOO_LONG, sizeof(TOO_LONG));
+    feed(ac, WRONG_LEN, sizeof(WRONG_LEN));
+    feed(ac, report, report_len);
+
+    CHECK(same(ac.get_capture(0), report, report_len));
+    CHECK(ac.get_capture(0)->kind == CaptureKind::RX);
+    CHECK(same(ac.get_capture(1), broken, report_len));
+    CHECK(ac.get_capture(1)->kind == CaptureKind::RX_CHECKSUM_ERROR);
+    CHECK(same(ac.get_capture(2), TOO_LONG, sizeof(TOO_LONG)));
+    CHECK(ac.get_capture(2)->kind == CaptureKind::RX_LENGTH_ERROR);
+    CHECK(same(ac.get_capture(3), WRONG_LEN, sizeof(WRONG_LEN)));
+    CHECK(ac.get_capture(3)->kind == CaptureKind::RX_LENGTH_ERROR);
+    CHECK(same(ac.get_capture(4), report, report_len));
+    CHECK(ac.get_capture(4)->kind == CaptureKind::RX);
+    CHECK(ac.get_capture(5) == nullptr);
+
+    /* the frame answering the last report */
+    for (int i = 0; i < 1000 && ac.get_capture(5) == nullptr; i++)
+    {
+        host::virtual_millis++;
+        ac.loop();
+    }
+    CHECK(ac.get_capture(5) != nullptr && ac.get_capture(5)->kind == CaptureKind::TX);
+    CHECK_EQ(ac.get_capture(5)->len, protocol::SET_FRAME_LEN);
+}
+
+/* every AC has its own ring, older frames are overwritten */
+static void test_capture_per_instance()
+{
+    host::virtual_millis = 0;
+    host::HostAC small;
+    host::HostAC off;
+    small.set_capture_frames(2);
+    small.setup();
+    off.setup();
+
+    static const uint8_t TOO_LONG[] = {0x7E, 0x7E, 0xF0};
+    static const uint8_t TOO_SHORT[] = {0x7E, 0x7E, 0x01};
+    uint8_t report[DATA_MAX];
+    size_t report_len = parse_hex(REPORT_OFF, report, sizeof(report));
+    for (host::HostAC *ac : {&small, &off})
+    {
+        feed(*ac, report, report_len);
+        feed(*ac, TOO_LONG, sizeof(TOO_LONG));
+        feed(*ac, TOO_SHORT, sizeof(TOO_SHORT));
+    }
+
+    CHECK(same(small.get_capture(0), TOO_LONG, sizeof(TOO_LONG)));
+    CHECK(same(small.get_capture(1), TOO_SHORT, sizeof(TOO_SHORT)));
+    CHECK(small.get_capture(2) == nullptr);
+    CHECK(off.get_capture(0) == nullptr);
+
+    /* dump button of each AC, without capture there is only a warning */
+    SinclairACButton small_dump;
+    SinclairACButton off_dump;
+    small_dump.set_parent(&small);
+    off_dump.set_parent(&off);
+    small_dump.press();
+    off_dump.press();
+}
+
+int main()
+{
+    logger::global_logger->set_log_level(ESPHOME_LOG_LEVEL_ERROR);
+
+    test_capture_errors();
+    test_capture_per_instance();
+    return check::result();
+}
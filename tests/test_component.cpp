@@ -0,0 +1,169 @@
+// SinclairACCNT behaviour towards its entities - driven through the host UART under the virtual clock
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "check.h"
+#include "esphome/components/logger/logger.h"
+#include "host_ac.h"
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+/* unit report of tests/data/replay_sample.log - mode OFF, swings OFF, plasma OFF */
+static const char *const REPORT_OFF =
+    "7E.7E.2F.31.00.00.00.00.10.80.02.02.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00."
+    "00.00.00.00.00.00.02.00.00.43.00.00.39";
+
+static void feed_report(host::HostAC &ac, const char *hex)
+{
+    uint8_t data[DATA_MAX];
+    size_t len = parse_hex(hex, data, sizeof(data));
+    ac.uart.feed(data, len);
+    ac.loop();
+    ac.uart.take_tx();
+}
+
+/* entities changed while AC does not respond go back to the settings we have, once loop() runs */
+static void test_rejected_changes_republished()
+{
+    host::virtual_millis = 0;
+    host::HostAC ac;
+    ac.setup();
+    CHECK(!ac.ready());
+
+    uint32_t plasma_published = 0;
+    ac.plasma.add_on_state_callback([&](bool state) { plasma_published++; });
+
+    ac.plasma.turn_on();
+    ac.vertical_swing.make_call().set_option(vertical_swing_options::NAMES[vertical_swing_options::FULL]).perform();
+    CHECK(ac.plasma.state);
+    CHECK(ac.vertical_swing.state == vertical_swing_options::NAMES[vertical_swing_options::FULL]);
+    CHECK(ac.update_ == ACUpdate::NoUpdate);
+
+    host::virtual_millis = 10;
+    ac.loop();
+    CHECK(!ac.plasma.state);
+    CHECK_EQ(plasma_published, 2);
+    CHECK(ac.vertical_swing.state == vertical_swing_options::NAMES[vertical_swing_options::OFF]);
+    CHECK(!ac.settings_.plasma);
+    CHECK_EQ(ac.settings_.vertical_swing, vertical_swing_options::OFF);
+
+    /* untouched entities are left for the first report */
+    CHECK(ac.horizontal_swing.state.empty());
+
+    /* nothing more to publish */
+    host::virtual_millis = 20;
+    ac.loop();
+    CHECK_EQ(plasma_published, 2);
+
+    /* once AC responds changes are accepted and kept */
+    host::virtual_millis = 100;
+    feed_report(ac, REPORT_OFF);
+    CHECK(ac.ready());
+    ac.plasma.turn_on();
+    host::virtual_millis = 110;
+    ac.loop();
+    CHECK(ac.plasma.state);
+    CHECK(ac.settings_.plasma);
+    CHECK(ac.update_ != ACUpdate::NoUpdate);
+}
+
+/* state packed to bitfields - sizes are printed for the per-instance RAM comparison, the last option of every
+   field has to come back unchanged */
+static void test_settings_size()
+{
+    printf("sizeof(ACSettings_t) = %zu, sizeof(SinclairACCNT) = %zu\n", sizeof(ACSettings_t), sizeof(SinclairACCNT));
+    CHECK(sizeof(ACSettings_t) <= 3);
+
+    ACSettings_t settings = {};
+    settings.fan_mode = fan_modes::COUNT - 1;
+    settings.vertical_swing = vertical_swing_options::COUNT - 1;
+    settings.horizontal_swing = horizontal_swing_options::COUNT - 1;
+    settings.display = display_options::COUNT - 1;
+    settings.display_mode = display_options::COUNT - 1;
+    settings.display_unit = display_unit_options::COUNT - 1;
+    settings.plasma = true;
+    settings.save = true;
+    CHECK_EQ(settings.fan_mode, fan_modes::COUNT - 1);
+    CHECK_EQ(settings.vertical_swing, vertical_swing_options::COUNT - 1);
+    CHECK_EQ(settings.horizontal_swing, horizontal_swing_options::COUNT - 1);
+    CHECK_EQ(settings.display, display_options::COUNT - 1);
+    CHECK_EQ(settings.display_mode, display_options::COUNT - 1);
+    CHECK_EQ(settings.display_unit, display_unit_options::COUNT - 1);
+    CHECK(settings.plasma && !settings.sleep && !settings.xfan && settings.save);
+}
+
+/* a report followed by another frame in the same UART read - the report is handled first, nothing is dropped */
+static void test_report_not_dropped_by_next_frame()
+{
+    host::virtual_millis = 0;
+    host::HostAC ac;
+    ac.setup();
+
+    uint8_t data[2 * DATA_MAX];
+    size_t len = parse_hex(REPORT_OFF, data, sizeof(data));
+    /* 0x44 frame AC sends besides reports, not handled by the component */
+    const uint8_t other_len = 0x1A;
+    const uint8_t other[] = {0x7E, 0x7E, other_len, protocol::CMD_IN_UNKNOWN_1};
+    memcpy(data + len, other, sizeof(other));
+    len += sizeof(other);
+    memset(data + len, 0, other_len - 2);
+    len += other_len - 2;
+    data[len++] = (uint8_t) (other_len + protocol::CMD_IN_UNKNOWN_1);
+    ac.uart.feed(data, len);
+
+    host::virtual_millis = 10;
+    ac.loop();
+    CHECK(ac.ready());
+    CHECK(ac.horizontal_swing.state == horizontal_swing_options::NAMES[horizontal_swing_options::OFF]);
+    CHECK_EQ(ac.get_link_stats().rx_frames, 1);
+
+    /* the other frame completes once the slot of the report is free again */
+    host::virtual_millis = 20;
+    ac.loop();
+    CHECK_EQ(ac.get_link_stats().rx_frames, 2);
+    CHECK_EQ(ac.get_unknown_packets(), 1);
+    CHECK_EQ(ac.get_dropped_frames(), 0);
+    CHECK(ac.uart.available() == 0);
+}
+
+/* frames of types the component does not handle are taken with any LEN - other models send other lengths */
+static void test_unhandled_packet_lengths()
+{
+    host::virtual_millis = 0;
+    host::HostAC ac;
+    ac.setup();
+
+    const uint8_t cmds[] = {protocol::CMD_IN_UNKNOWN_1, protocol::CMD_IN_UNKNOWN_2, 0x99};
+    const uint8_t lens[] = {FRAME_LEN_MIN, 0x10, 0x1A, 0x2F, 0x60, FRAME_LEN_MAX};
+    uint32_t frames = 0;
+    for (uint8_t cmd : cmds)
+    {
+        for (uint8_t len : lens)
+        {
+            uint8_t data[DATA_MAX] = {0x7E, 0x7E, len, cmd};
+            data[len + 2] = (uint8_t) (len + cmd);
+            ac.uart.feed(data, len + 3);
+            host::virtual_millis += 10;
+            ac.loop();
+            frames++;
+        }
+    }
+    CHECK_EQ(ac.get_link_stats().rx_frames, frames);
+    CHECK_EQ(ac.get_unknown_packets(), frames);
+    CHECK_EQ(ac.get_link_stats().length_errors, 0);
+    CHECK_EQ(ac.get_link_stats().resyncs, 0);
+}
+
+int main()
+{
+    logger::global_logger->set_log_level(ESPHOME_LOG_LEVEL_ERROR);
+
+    test_settings_size();
+    test_rejected_changes_republished();
+    test_report_not_dropped_by_next_frame();
+    test_unhandled_packet_lengths();
+    return check::result();
+}
@@ -0,0 +1,185 @@
+// serial_parse() on tests/data/corrupted_stream.bin - unit reports with corrupted LEN bytes, every corrupted frame has
+// to be rejected at its LEN or CMD byte without losing any of the good reports around it.
+// Usage: test_framing corrupted_stream.bin, or test_framing --write corrupted_stream.bin to generate the corpus
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "check.h"
+#include "esppac_core.h"
+
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+static const size_t REPORTS = 2000;
+static const size_t CORRUPTED_EVERY = 5;
+static const size_t REPORT_FRAME_LEN = protocol::SET_FRAME_LEN;  /* reports share length with SET frames */
+
+/* kinds of corruption, cycled through by corrupted reports */
+enum Corruption {
+    LEN_ZERO,         /* LEN < 2 - rejected by the LEN bounds */
+    LEN_OVERSIZED,    /* LEN > FRAME_LEN_MAX - rejected by the LEN bounds */
+    LEN_TOO_LONG,     /* fits the buffer, too long for a unit report - rejected at CMD */
+    LEN_TOO_SHORT,    /* fits the buffer, too short for a unit report - rejected at CMD */
+    CORRUPTION_COUNT
+};
+
+static Corruption corruption(size_t report)
+{
+    return (Corruption) ((report / CORRUPTED_EVERY) % CORRUPTION_COUNT);
+}
+
+static bool corrupted(size_t report)
+{
+    return report % CORRUPTED_EVERY == CORRUPTED_EVERY - 1;
+}
+
+/* unit reports as AC sends them, target and room temperature changing, every fifth one with its LEN replaced */
+static std::vector<uint8_t> corrupted_stream()
+{
+    std::vector<uint8_t> stream;
+    SetFrame report;
+    report.init(protocol::CMD_IN_UNIT_REPORT);
+    ACSettings_t settings = {};
+    settings.fan_mode = fan_modes::FAN_AUTO;
+    report.encode_mode(protocol::REPORT_MODE_COOL, true);
+    report.encode_fan_mode(settings.fan_mode);
+    report.encode_vertical_swing(vertical_swing_options::OFF);
+    report.encode_horizontal_swing(horizontal_swing_options::OFF);
+    report.encode_display(display_options::AUTO, display_options::AUTO);
+    report.encode_flags(settings);
+    for (size_t i = 0; i < REPORTS; i++)
+    {
+        report.encode_target_temperature(16 + i % 15);
+        report.encode_current_temperature(20.0f + (i % 20) / 2.0f);
+        size_t start = stream.size();
+        stream.insert(stream.end(), report.data(), report.data() + report.size());
+        if (!corrupted(i))
+        {
+            continue;
+        }
+        uint8_t &len = stream[start + 2];
+        switch (corruption(i))
+        {
+            case LEN_ZERO:
+                len = (i / (CORRUPTED_EVERY * CORRUPTION_COUNT)) & 1;
+                break;
+            case LEN_OVERSIZED:
+                len = FRAME_LEN_MAX + 1 + i % (0xFF - FRAME_LEN_MAX);
+                break;
+            case LEN_TOO_LONG:
+                len = 0x80 + i % 0x40;
+                break;
+            default:
+                len = protocol::REPORT_LEN_MIN - 1 - i % 8;
+                break;
+        }
+    }
+    return stream;
+}
+
+static bool header_check(void *ctx, uint8_t len, uint8_t cmd)
+{
+    return is_valid_header(len, cmd);
+}
+
+static std::vector<uint8_t> load(const char *path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return data;
+    }
+    uint8_t buf[256];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+    {
+        data.insert(data.end(), buf, buf + len);
+    }
+    fclose(file);
+    return data;
+}
+
+/* every corrupted frame ends in an error event at its LEN or CMD byte, right where the parser goes back to waiting
+   for sync, and every good report comes out as a frame */
+static void test_corrupted_stream(const std::vector<uint8_t> &stream)
+{
+    CHECK_EQ(stream.size(), REPORTS * REPORT_FRAME_LEN);
+    if (stream.size() != REPORTS * REPORT_FRAME_LEN)
+        return;
+
+    SerialProcess_t process = {};
+    size_t frames = 0;
+    size_t length_errors = 0;
+    size_t header_errors = 0;
+    size_t misplaced = 0;
+    size_t resync_bytes = 0;
+    for (size_t pos = 0; pos < stream.size();)
+    {
+        FrameEvent event;
+        pos += serial_parse(process, stream.data() + pos, stream.size() - pos, header_check, nullptr, event);
+        size_t report = (pos - 1) / REPORT_FRAME_LEN;
+        size_t offset = pos - report * REPORT_FRAME_LEN;  /* bytes of the report consumed */
+        switch (event)
+        {
+            case FrameEvent::FRAME:
+                frames++;
+                misplaced += (corrupted(report) || offset != REPORT_FRAME_LEN);
+                process.pending = nullptr;
+                break;
+            case FrameEvent::LENGTH_ERROR:
+                length_errors++;
+                misplaced += (!corrupted(report) || offset != 3);
+                resync_bytes += offset;
+                break;
+            case FrameEvent::HEADER_ERROR:
+                header_errors++;
+                misplaced += (!corrupted(report) || offset != 4);
+                resync_bytes += offset;
+                break;
+            case FrameEvent::CHECKSUM_ERROR:
+                misplaced++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    size_t bad = REPORTS / CORRUPTED_EVERY;
+    printf("%zu reports, %zu with corrupted LEN: %zu frames, %zu length errors, %zu header errors, "
+           "%.2f bytes to resync\n", REPORTS, bad, frames, length_errors, header_errors,
+           (double) resync_bytes / (length_errors + header_errors));
+    CHECK_EQ(frames, REPORTS - bad);
+    CHECK_EQ(length_errors, bad / CORRUPTION_COUNT * 2);
+    CHECK_EQ(header_errors, bad / CORRUPTION_COUNT * 2);
+    CHECK_EQ(misplaced, 0);
+    CHECK(process.state == STATE_WAIT_SYNC);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--write") == 0)
+    {
+        std::vector<uint8_t> stream = corrupted_stream();
+        FILE *file = fopen(argv[2], "wb");
+        if (file == nullptr || fwrite(stream.data(), 1, stream.size(), file) != stream.size())
+        {
+            printf("Cannot write %s\n", argv[2]);
+            return 1;
+        }
+        fclose(file);
+        return 0;
+    }
+    if (argc != 2)
+    {
+        printf("Usage: %s [--write] corrupted_stream.bin\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> stream = load(argv[1]);
+    /* the corpus is what the generator above writes, so its layout is known here */
+    CHECK(stream == corrupted_stream());
+    test_corrupted_stream(stream);
+    return check::result();
+}
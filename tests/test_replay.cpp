@@ -0,0 +1,103 @@
+// SinclairAC::replay_packet() and parse_hex() - replayed frames reach the handlers without touching the link
+#include <cstring>
+#include <string>
+
+#include "check.h"
+#include "esphome/components/logger/logger.h"
+#include "host_ac.h"
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+
+/* unit reports of tests/data/replay_sample.log - mode OFF and HEAT 24 */
+static const char *const REPORT_OFF =
+    "7E.7E.2F.31.00.00.00.00.10.80.02.02.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00."
+    "00.00.00.00.00.00.02.00.00.43.00.00.39";
+static const char *const REPORT_HEAT =
+    "7E.7E.2F.31.00.00.00.00.C1.80.02.02.00.00.00.00.00.00.00.00.00.00.01.00.00.00.00.00.00.00.00.00.00.00.00.00.00."
+    "00.00.00.00.00.00.02.00.00.43.00.00.EB";
+
+static size_t hex_len(const char *text)
+{
+    uint8_t data[DATA_MAX];
+    return parse_hex(text, data, sizeof(data));
+}
+
+static void test_parse_hex()
+{
+    uint8_t data[8];
+    CHECK_EQ(parse_hex("7E.7E.2F", data, sizeof(data)), 3);
+    CHECK_EQ(data[2], 0x2F);
+    CHECK_EQ(parse_hex("7e 7e 2f 31", data, sizeof(data)), 4);
+
+    /* length suffix of format_hex_pretty() must match the bytes */
+    CHECK_EQ(parse_hex("7E.7E.2F.31.00 (5)", data, sizeof(data)), 5);
+    CHECK_EQ(parse_hex("7E.7E.2F.31.00 (5)\r\n", data, sizeof(data)), 5);
+    CHECK_EQ(parse_hex("7E.7E.2F.31.00 (6)", data, sizeof(data)), 0);
+    CHECK_EQ(parse_hex("7E.7E.2F.31.00 (5", data, sizeof(data)), 0);
+    CHECK_EQ(parse_hex("7E.7E.2F.31.00 (5) 00", data, sizeof(data)), 0);
+    CHECK_EQ(parse_hex("7E.7E.2F.31.00 (500000000000)", data, sizeof(data)), 0);
+
+    CHECK_EQ(parse_hex("7E.7G", data, sizeof(data)), 0);
+    CHECK_EQ(parse_hex("00.01.02.03.04.05.06.07.08", data, sizeof(data)), 0);
+    CHECK_EQ(hex_len((std::string(REPORT_OFF) + " (50)").c_str()), 50);
+}
+
+static void test_replay_leaves_link_alone()
+{
+    host::virtual_millis = 0;
+    host::HostAC ac;
+    ac.setup();
+
+    uint32_t published = 0;
+    ac.add_on_state_callback([&](climate::Climate &climate) { published++; });
+
+    /* live frame cut in half when the replay comes */
+    uint8_t live[DATA_MAX];
+    size_t live_len = parse_hex(REPORT_OFF, live, sizeof(live));
+    host::virtual_millis = 100;
+    ac.uart.feed(live, 20);
+    ac.loop();
+    CHECK(ac.serialProcess_.state == STATE_RECIEVE);
+
+    LinkStats_t link = ac.get_link_stats();
+    uint32_t dropped = ac.get_dropped_frames();
+    uint32_t timeouts = ac.get_timeout_frames();
+
+    /* two frames in one string, the second one is handled too */
+    ac.replay_packet(std::string(REPORT_OFF) + "." + REPORT_HEAT + " (100)");
+    CHECK(ac.mode == climate::CLIMATE_MODE_HEAT);
+    CHECK(published >= 2);
+
+    /* broken and incomplete replays are only logged */
+    std::string broken = REPORT_HEAT;
+    broken[broken.size() - 1] = '0';
+    ac.replay_packet(broken);
+    ac.replay_packet("7E.7E.2F.31");
+    ac.replay_packet("not hex");
+
+    const LinkStats_t &after = ac.get_link_stats();
+    CHECK_EQ(after.rx_frames, link.rx_frames);
+    CHECK_EQ(after.checksum_errors, link.checksum_errors);
+    CHECK_EQ(after.length_errors, link.length_errors);
+    CHECK_EQ(after.resyncs, link.resyncs);
+    CHECK_EQ(ac.get_dropped_frames(), dropped);
+    CHECK_EQ(ac.get_timeout_frames(), timeouts);
+
+    /* the live frame completes as if there was no replay */
+    host::virtual_millis = 110;
+    ac.uart.feed(live + 20, live_len - 20);
+    ac.loop();
+    CHECK_EQ(ac.get_link_stats().rx_frames, link.rx_frames + 1);
+    CHECK_EQ(ac.get_link_stats().checksum_errors, link.checksum_errors);
+    CHECK(ac.mode == climate::CLIMATE_MODE_OFF);
+}
+
+int main()
+{
+    logger::global_logger->set_log_level(ESPHOME_LOG_LEVEL_ERROR);
+
+    test_parse_hex();
+    test_replay_leaves_link_alone();
+    return check::result();
+}
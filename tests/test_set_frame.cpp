@@ -0,0 +1,175 @@
+// SET frames of SinclairACCNT::send_packet() byte for byte against tests/data/set_frames.golden, recorded from the
+// encoder the component had before SetFrame. Usage: test_set_frame set_frames.golden
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "check.h"
+#include "esphome/components/logger/logger.h"
+#include "host_ac.h"
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+typedef struct {
+        climate::ClimateMode mode;
+        climate::ClimateMode mode_internal;
+        float target_temperature;
+        ACSettings_t settings;
+        ACUpdate update;
+        uint8_t frame[DATA_MAX];
+        size_t frame_len;
+        int line;
+} GoldenFrame_t;
+
+static std::vector<GoldenFrame_t> load(const char *path)
+{
+    std::vector<GoldenFrame_t> frames;
+    FILE *file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        return frames;
+    }
+    char line[512];
+    for (int number = 1; fgets(line, sizeof(line), file) != nullptr; number++)
+    {
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+        unsigned mode, mode_internal, fan, vswing, hswing, display, display_mode, unit, plasma, sleep, xfan, save, update;
+        int used = 0;
+        GoldenFrame_t golden = {};
+        if (sscanf(line, "%u %u %f %u %u %u %u %u %u %u %u %u %u %u %n", &mode, &mode_internal, &golden.target_temperature,
+                   &fan, &vswing, &hswing, &display, &display_mode, &unit, &plasma, &sleep, &xfan, &save, &update, &used) != 14)
+        {
+            printf("%s:%d: malformed line\n", path, number);
+            frames.clear();
+            break;
+        }
+        golden.mode = (climate::ClimateMode) mode;
+        golden.mode_internal = (climate::ClimateMode) mode_internal;
+        golden.settings.fan_mode = fan;
+        golden.settings.vertical_swing = vswing;
+        golden.settings.horizontal_swing = hswing;
+        golden.settings.display = display;
+        golden.settings.display_mode = display_mode;
+        golden.settings.display_unit = unit;
+        golden.settings.plasma = plasma;
+        golden.settings.sleep = sleep;
+        golden.settings.xfan = xfan;
+        golden.settings.save = save;
+        static const ACUpdate UPDATES[] = {ACUpdate::NoUpdate, ACUpdate::UpdateStart, ACUpdate::UpdateClear};
+        golden.update = UPDATES[update % 3];
+        golden.frame_len = parse_hex(line + used, golden.frame, sizeof(golden.frame));
+        golden.line = number;
+        frames.push_back(golden);
+    }
+    fclose(file);
+    return frames;
+}
+
+/* frame the component sends for the state of given line */
+static std::vector<uint8_t> send(host::HostAC &ac, const GoldenFrame_t &golden)
+{
+    ac.mode = golden.mode;
+    ac.mode_internal_ = golden.mode_internal;
+    ac.target_temperature = golden.target_temperature;
+    ac.settings_ = golden.settings;
+    ac.update_ = golden.update;
+    ac.wait_response_ = false;
+    host::virtual_millis += protocol::TIME_REFRESH_INIT_MAX_MS;
+    ac.send_packet();
+    return ac.uart.take_tx();
+}
+
+static bool matches(const GoldenFrame_t &golden, const std::vector<uint8_t> &frame, const char *how)
+{
+    if (frame.size() == golden.frame_len && memcmp(frame.data(), golden.frame, golden.frame_len) == 0)
+    {
+        return true;
+    }
+    printf("line %d, %s: frame differs\n   ", golden.line, how);
+    for (uint8_t byte : frame)
+    {
+        printf(" %02X", byte);
+    }
+    printf(" (%zu)\n", frame.size());
+    return false;
+}
+
+/* every frame built from scratch, as the first one after boot */
+static void test_fresh_frames(const std::vector<GoldenFrame_t> &frames)
+{
+    for (const GoldenFrame_t &golden : frames)
+    {
+        host::virtual_millis = 0;
+        host::HostAC ac;
+        ac.setup();
+        CHECK(matches(golden, send(ac, golden), "fresh frame"));
+    }
+}
+
+/* one component going through all the lines - frame patched from the previous one must not differ from it */
+static void test_patched_frames(const std::vector<GoldenFrame_t> &frames)
+{
+    host::virtual_millis = 0;
+    host::HostAC ac;
+    ac.setup();
+    for (const GoldenFrame_t &golden : frames)
+    {
+        CHECK(matches(golden, send(ac, golden), "patched frame"));
+    }
+    /* and back in reverse, each field changes in the other direction too */
+    for (size_t i = frames.size(); i-- > 0;)
+    {
+        CHECK(matches(frames[i], send(ac, frames[i]), "patched frame, reverse"));
+    }
+}
+
+/* room temperature of unit reports - values the field cannot hold end at its limits instead of wrapping around */
+static void test_current_temperature_range()
+{
+    static const size_t RAW_BYTE = 4 + protocol::REPORT_TEMP_ACT_BYTE;  /* sync bytes, LEN and CMD before payload */
+    static const struct {
+        float temperature;
+        uint8_t raw;
+    } CASES[] = {
+        {20.0f, 56},
+        {-8.0f, 0},
+        {-8.5f, 0},
+        {-40.0f, 0},
+        {119.5f, 255},
+        {120.0f, 255},
+        {1e9f, 255},
+        {-1e9f, 0},
+        {NAN, 0},
+    };
+    SetFrame report;
+    report.init(protocol::CMD_IN_UNIT_REPORT);
+    for (const auto &test : CASES)
+    {
+        report.encode_current_temperature(test.temperature);
+        CHECK_EQ(report.data()[RAW_BYTE], test.raw);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    logger::global_logger->set_log_level(ESPHOME_LOG_LEVEL_ERROR);
+
+    if (argc < 2)
+    {
+        printf("Usage: %s set_frames.golden\n", argv[0]);
+        return 1;
+    }
+    std::vector<GoldenFrame_t> frames = load(argv[1]);
+    CHECK(frames.size() >= 100);
+
+    test_fresh_frames(frames);
+    test_patched_frames(frames);
+    test_current_temperature_range();
+    return check::result();
+}
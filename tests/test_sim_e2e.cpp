@@ -0,0 +1,184 @@
+// End to end - SinclairACCNT against the simulated unit under virtual time, measures command apply latency and
+// throughput on a clean and on an adverse line. Run directly to see the table, ctest only checks the outcome.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "check.h"
+#include "esphome/components/logger/logger.h"
+#include "host_ac.h"
+#include "unit_simulator.h"
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+static const uint32_t COMMANDS = 40;
+static const uint32_t COMMAND_TIMEOUT = 15000;  /* ms for a command to be confirmed or given up by the component */
+
+typedef struct {
+        const char *name;
+        SimConfig_t config;
+        bool lossless;  /* every command is expected to be applied with no retry */
+} Condition_t;
+
+/* response, period, apply latency, noise, drop, strict, seed */
+static const Condition_t CONDITIONS[] = {
+    {"clean",                     {20, 0,   0,   0.0f,   0.0f,   true, 1}, true},
+    {"unsolicited reports 300ms", {20, 300, 0,   0.0f,   0.0f,   true, 1}, true},
+    {"apply latency 400ms",       {20, 0,   400, 0.0f,   0.0f,   true, 1}, false},
+    {"noise 0.2%/byte",           {20, 0,   0,   0.002f, 0.0f,   true, 2}, false},
+    {"drop 0.2%/byte",            {20, 0,   0,   0.0f,   0.002f, true, 3}, false},
+    {"noise+drop 1%/byte, 300ms", {20, 300, 100, 0.01f,  0.01f,  true, 4}, false},
+};
+
+typedef struct {
+        uint32_t completed;     /* confirmed or given up by the component */
+        uint32_t confirmed;     /* apply latency published */
+        uint32_t unit_applied;  /* the unit ended up with the requested settings */
+        uint32_t retries;
+        uint32_t failed;
+        std::vector<uint32_t> latency;  /* ms from control() to the confirming report */
+        uint32_t sim_ms;
+        double wall_s;
+        LinkStats_t link;
+        SimStats_t unit;
+} Result_t;
+
+/* one ms of virtual time - unit bytes due by now go to UART, the component runs, its bytes go to the unit */
+static void step(host::HostAC &ac, UnitSimulator &unit)
+{
+    uint32_t now = ++host::virtual_millis;
+
+    uint8_t buf[64];
+    size_t len;
+    while ((len = unit.read(buf, sizeof(buf), now)) > 0)
+    {
+        ac.uart.feed(buf, len);
+    }
+
+    ac.loop();
+
+    std::vector<uint8_t> tx = ac.uart.take_tx();
+    if (!tx.empty())
+    {
+        unit.write(tx.data(), tx.size(), now);
+    }
+}
+
+static bool unit_has(const UnitReport_t &state, uint8_t mode, uint8_t target, uint8_t fan, uint8_t vertical_swing)
+{
+    return state.power && state.mode == mode && state.target_temperature == target &&
+           state.settings.fan_mode == fan && state.settings.vertical_swing == vertical_swing;
+}
+
+static Result_t run(const Condition_t &condition)
+{
+    Result_t result = {};
+    host::virtual_millis = 0;
+
+    host::HostAC ac;
+    UnitSimulator unit(condition.config);
+    uint32_t confirmations = 0;
+    ac.apply_latency.add_on_state_callback([&](float latency) {
+        confirmations++;
+        result.latency.push_back(latency);
+    });
+
+    auto wall_start = std::chrono::steady_clock::now();
+    ac.setup();
+    for (uint32_t ms = 0; ms < 10000 && !ac.ready(); ms++)
+    {
+        step(ac, unit);
+    }
+    CHECK(ac.ready());
+
+    uint32_t start = host::virtual_millis;
+    for (uint32_t i = 0; i < COMMANDS; i++)
+    {
+        bool heat = i & 1;
+        uint8_t target = 17 + i % 13;
+        uint8_t fan = 1 + i % (fan_modes::COUNT - 1);
+        uint8_t vertical_swing = ac.settings_.vertical_swing;
+
+        uint32_t confirmed = confirmations;
+        ac.make_call()
+            .set_mode(heat ? climate::CLIMATE_MODE_HEAT : climate::CLIMATE_MODE_COOL)
+            .set_target_temperature(target)
+            .set_fan_mode(fan_modes::NAMES[fan])
+            .perform();
+        if (i % 3 == 0)
+        {
+            /* a select changed together with climate goes to AC in the same update */
+            vertical_swing = 2 + i % (vertical_swing_options::COUNT - 2);
+            ac.vertical_swing.make_call().set_option(vertical_swing_options::NAMES[vertical_swing]).perform();
+        }
+
+        for (uint32_t ms = 0; ms < COMMAND_TIMEOUT; ms++)
+        {
+            step(ac, unit);
+            if (ac.update_ == ACUpdate::NoUpdate && !ac.confirm_pending_)
+            {
+                result.completed++;
+                break;
+            }
+        }
+        result.confirmed += confirmations != confirmed;
+        result.unit_applied += unit_has(unit.state(), heat ? protocol::REPORT_MODE_HEAT : protocol::REPORT_MODE_COOL,
+                                        target, fan, vertical_swing);
+    }
+    result.sim_ms = host::virtual_millis - start;
+    result.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    CHECK(ac.ready());
+    result.retries = ac.get_update_retries();
+    result.failed = ac.get_failed_updates();
+    result.link = ac.get_link_stats();
+    result.unit = unit.stats();
+    return result;
+}
+
+static uint32_t percentile(std::vector<uint32_t> values, uint8_t percent)
+{
+    if (values.empty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    return values[(values.size() - 1) * percent / 100];
+}
+
+int main()
+{
+    /* retries and given up updates are counted, their log lines would only bury the table */
+    logger::global_logger->set_log_level(ESPHOME_LOG_LEVEL_ERROR);
+
+    printf("%-28s %5s %5s %5s %5s %5s %7s %7s %8s %8s %8s %8s\n", "condition", "cmds", "conf", "unit", "retry", "fail",
+           "p50 ms", "max ms", "cmd/s", "rx fr/s", "tx fr/s", "sim x");
+    for (const Condition_t &condition : CONDITIONS)
+    {
+        Result_t r = run(condition);
+        double sim_s = r.sim_ms / 1000.0;
+        printf("%-28s %5u %5u %5u %5u %5u %7u %7u %8.2f %8.2f %8.2f %8.0f\n", condition.name, (unsigned) COMMANDS,
+               (unsigned) r.confirmed, (unsigned) r.unit_applied, (unsigned) r.retries, (unsigned) r.failed,
+               (unsigned) percentile(r.latency, 50), (unsigned) percentile(r.latency, 100), COMMANDS / sim_s,
+               r.link.rx_frames / sim_s, r.link.tx_frames / sim_s, sim_s / r.wall_s);
+
+        /* component never gets stuck - every command ends confirmed or given up */
+        CHECK_EQ(r.completed, COMMANDS);
+        CHECK_EQ(r.confirmed + r.failed, COMMANDS);
+        if (condition.lossless)
+        {
+            CHECK_EQ(r.confirmed, COMMANDS);
+            CHECK_EQ(r.unit_applied, COMMANDS);
+            CHECK_EQ(r.retries, 0);
+            CHECK_EQ(r.unit.ignored, 0);
+            CHECK(percentile(r.latency, 100) < 1000);
+        }
+        else
+        {
+            /* retries recover most of the commands the line or the unit lost */
+            CHECK(r.unit_applied >= COMMANDS * 8 / 10);
+        }
+    }
+    return check::result();
+}
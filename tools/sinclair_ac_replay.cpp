@@ -0,0 +1,403 @@
+// Replays captured UART traffic - ESPHome logs with RX lines of log_packet() or raw binary captures - through
+// SinclairACCNT under a virtual clock and prints a deterministic trace of state transitions and publishes
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "esphome/components/logger/logger.h"
+#include "host_ac.h"
+
+using namespace esphome;
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+static const char *const CLIMATE_MODES[] = {"OFF", "HEAT_COOL", "COOL", "HEAT", "FAN_ONLY", "DRY", "AUTO"};
+static const char *const SWING_MODES[] = {"OFF", "BOTH", "VERTICAL", "HORIZONTAL"};
+
+static const uint32_t FIRST_FRAME_TIME = 10;  /* ms of virtual time before the first captured bytes */
+static const size_t BINARY_SLICE = 8;         /* bytes of a binary capture a loop() finds in UART, within READ_TIMEOUT */
+
+/* Bytes recieved together - a logged frame or a slice of a binary capture */
+typedef struct {
+        uint32_t time;              /* ms of virtual time at which the last byte was recieved */
+        std::vector<uint8_t> data;
+        std::string hex;            /* logged text, for --direct */
+} Chunk_t;
+
+/* Trace is collected as text, so it can be printed or compared, nothing is formatted while benchmarking */
+static bool trace_enabled = true;
+static std::string trace;
+
+static void emit(const char *format, ...) __attribute__((format(printf, 1, 2)));
+static void emit(const char *format, ...)
+{
+    if (!trace_enabled)
+        return;
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    trace += line;
+    trace += '\n';
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] FILE\n"
+            "  --binary           FILE is a raw capture of bytes recieved from AC, not a log\n"
+            "  --direct           log lines go through SinclairAC::replay_packet() instead of UART and loop()\n"
+            "  --check TRACE      compare the trace with TRACE file instead of printing it\n"
+            "  --bench N          replay N times without trace and report throughput\n"
+            "  --verbose          print component log at VERBOSE level to stderr\n",
+            name);
+}
+
+/*
+ * Input
+ */
+
+static bool read_file(const char *path, std::string &content)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        perror(path);
+        return false;
+    }
+    char buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+    {
+        content.append(buf, len);
+    }
+    fclose(file);
+    return true;
+}
+
+/* "[12:34:56]" or "[12:34:56.789]" prefix added by esphome logs, -1 if there is none */
+static int64_t log_timestamp(const std::string &line)
+{
+    unsigned h, m, s, ms = 0;
+    int len = 0;
+    if (sscanf(line.c_str(), "[%2u:%2u:%2u]%n", &h, &m, &s, &len) == 3 && len > 0)
+        return ((h * 60 + m) * 60 + s) * 1000;
+    if (sscanf(line.c_str(), "[%2u:%2u:%2u.%3u]%n", &h, &m, &s, &ms, &len) == 4 && len > 0)
+        return ((h * 60 + m) * 60 + s) * 1000 + ms;
+    return -1;
+}
+
+/* colors of ESPHome log output would read as hex digits */
+static std::string strip_escapes(const std::string &line)
+{
+    std::string plain;
+    for (size_t i = 0; i < line.size(); i++)
+    {
+        if (line[i] == '\033' && i + 1 < line.size() && line[i + 1] == '[')
+        {
+            for (i += 2; i < line.size() && !((line[i] >= 'A' && line[i] <= 'Z') || (line[i] >= 'a' && line[i] <= 'z')); i++)
+            {
+            }
+            continue;
+        }
+        plain += line[i];
+    }
+    return plain;
+}
+
+/* RX lines of the log, TX lines are our own frames and only counted. Without timestamps, or within the same
+   second, frames follow each other after their airtime. */
+static bool load_log(const std::string &content, std::vector<Chunk_t> &chunks, uint32_t &tx_lines, uint32_t &malformed)
+{
+    int64_t first = -1;
+    int64_t previous = -1;
+    int64_t day = 0;
+    uint32_t time = FIRST_FRAME_TIME;
+    size_t pos = 0;
+    while (pos < content.size())
+    {
+        size_t end = content.find('\n', pos);
+        if (end == std::string::npos)
+            end = content.size();
+        std::string line = strip_escapes(content.substr(pos, end - pos));
+        pos = end + 1;
+
+        if (line.find("TX: ") != std::string::npos)
+        {
+            tx_lines++;
+            continue;
+        }
+        size_t rx = line.find("RX: ");
+        if (rx == std::string::npos)
+            continue;
+
+        Chunk_t chunk;
+        chunk.hex = line.substr(rx + 4);
+        uint8_t data[DATA_MAX];
+        size_t len = parse_hex(chunk.hex.c_str(), data, sizeof(data));
+        if (len == 0)
+        {
+            malformed++;
+            continue;
+        }
+        chunk.data.assign(data, data + len);
+
+        uint32_t airtime = protocol::airtime_ms(len);
+        int64_t stamp = log_timestamp(line);
+        if (stamp >= 0)
+        {
+            /* log went past midnight, lines slightly out of order are not */
+            if (previous >= 0 && stamp + 12 * 3600 * 1000 < previous)
+                day += 24 * 3600 * 1000;
+            previous = stamp;
+            if (first < 0)
+                first = stamp + day;
+            time = FIRST_FRAME_TIME + (stamp + day - first);
+            if (!chunks.empty())
+                time = std::max(time, chunks.back().time + airtime);
+        }
+        else
+        {
+            time += airtime;
+        }
+        chunk.time = time;
+        chunks.push_back(std::move(chunk));
+    }
+    return true;
+}
+
+/* bytes arrive back to back, in pieces a loop() every ~16 ms would find */
+static void load_binary(const std::string &content, std::vector<Chunk_t> &chunks)
+{
+    uint32_t time = FIRST_FRAME_TIME;
+    for (size_t pos = 0; pos < content.size(); pos += BINARY_SLICE)
+    {
+        size_t len = std::min(content.size() - pos, BINARY_SLICE);
+        Chunk_t chunk;
+        chunk.data.assign(content.begin() + pos, content.begin() + pos + len);
+        time += protocol::airtime_ms(len);
+        chunk.time = time;
+        chunks.push_back(std::move(chunk));
+    }
+}
+
+/*
+ * Replay
+ */
+
+class Replay {
+    public:
+        explicit Replay(bool direct) : direct_(direct)
+        {
+            host::HostAC &ac = this->ac_;
+            ac.add_on_state_callback([](climate::Climate &climate) {
+                emit("t=%u climate mode=%s target=%.1f current=%.1f fan=%s swing=%s", (unsigned) host::virtual_millis,
+                     CLIMATE_MODES[climate.mode], climate.target_temperature, climate.current_temperature,
+                     climate.custom_fan_mode.has_value() ? climate.custom_fan_mode->c_str() : "-",
+                     SWING_MODES[climate.swing_mode]);
+            });
+            for (select::Select *select : {&ac.vertical_swing, &ac.horizontal_swing, &ac.display, &ac.display_unit})
+            {
+                select->add_on_state_callback([select](const std::string &value, size_t index) {
+                    emit("t=%u select %s = %s", (unsigned) host::virtual_millis, select->get_name().c_str(), value.c_str());
+                });
+            }
+            for (switch_::Switch *sw : {(switch_::Switch *) &ac.plasma, (switch_::Switch *) &ac.sleep,
+                                        (switch_::Switch *) &ac.xfan, (switch_::Switch *) &ac.save})
+            {
+                sw->add_on_state_callback([sw](bool state) {
+                    emit("t=%u switch %s = %s", (unsigned) host::virtual_millis, sw->get_name().c_str(), state ? "ON" : "OFF");
+                });
+            }
+
+            host::virtual_millis = 0;
+            ac.setup();
+        }
+
+        void run(const std::vector<Chunk_t> &chunks)
+        {
+            for (const Chunk_t &chunk : chunks)
+            {
+                host::virtual_millis = chunk.time;
+                if (this->direct_)
+                {
+                    this->ac_.replay_packet(chunk.hex);
+                    continue;
+                }
+
+                /* time passes before the bytes come - partial frames time out, silent AC is noticed */
+                this->step();
+                this->ac_.uart.feed(chunk.data.data(), chunk.data.size());
+                do
+                {
+                    this->step();
+                } while (this->ac_.uart.available() > 0 || this->ac_.serialProcess_.pending != nullptr);
+                this->trace_errors();
+            }
+        }
+
+        void summary()
+        {
+            const LinkStats_t &link = this->ac_.get_link_stats();
+            emit("frames=%u checksum_errors=%u length_errors=%u timeout_frames=%u dropped_frames=%u unknown_packets=%u "
+                 "identical_reports=%u publishes=%u",
+                 (unsigned) link.rx_frames, (unsigned) link.checksum_errors, (unsigned) link.length_errors,
+                 (unsigned) this->ac_.get_timeout_frames(), (unsigned) this->ac_.get_dropped_frames(),
+                 (unsigned) this->ac_.get_unknown_packets(), (unsigned) this->ac_.get_identical_reports(),
+                 (unsigned) this->ac_.get_publishes_emitted());
+        }
+
+        uint32_t frames() { return this->ac_.get_link_stats().rx_frames; }
+
+    protected:
+        host::HostAC ac_;
+        bool direct_;
+        bool ready_ = false;
+        LinkStats_t link_ = {};
+        uint32_t timeout_frames_ = 0;
+        uint32_t unknown_packets_ = 0;
+
+        /* one loop() of the component, the frames it sends have nowhere to go */
+        void step()
+        {
+            this->ac_.loop();
+            this->ac_.uart.take_tx();
+            if (this->ac_.ready() != this->ready_)
+            {
+                this->ready_ = this->ac_.ready();
+                emit("t=%u state %s", (unsigned) host::virtual_millis, this->ready_ ? "Ready" : "Initializing");
+            }
+        }
+
+        void trace_errors()
+        {
+            const LinkStats_t &link = this->ac_.get_link_stats();
+            uint32_t now = host::virtual_millis;
+            if (link.checksum_errors != this->link_.checksum_errors)
+                emit("t=%u dropped frame: checksum", (unsigned) now);
+            if (link.length_errors != this->link_.length_errors)
+                emit("t=%u dropped frame: length", (unsigned) now);
+            if (this->ac_.get_timeout_frames() != this->timeout_frames_)
+                emit("t=%u dropped frame: incomplete", (unsigned) now);
+            if (this->ac_.get_unknown_packets() != this->unknown_packets_)
+                emit("t=%u unknown packet", (unsigned) now);
+            this->link_ = link;
+            this->timeout_frames_ = this->ac_.get_timeout_frames();
+            this->unknown_packets_ = this->ac_.get_unknown_packets();
+        }
+};
+
+int main(int argc, char **argv)
+{
+    bool binary = false;
+    bool direct = false;
+    bool verbose = false;
+    const char *check = nullptr;
+    long bench = 0;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--binary") == 0)
+            binary = true;
+        else if (strcmp(argv[i], "--direct") == 0)
+            direct = true;
+        else if (strcmp(argv[i], "--verbose") == 0)
+            verbose = true;
+        else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc)
+            check = argv[++i];
+        else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc)
+            bench = atol(argv[++i]);
+        else if (argv[i][0] != '-' && path == nullptr)
+            path = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (path == nullptr || (binary && direct))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    logger::global_logger->set_log_level(verbose ? ESPHOME_LOG_LEVEL_VERBOSE : ESPHOME_LOG_LEVEL_NONE);
+
+    std::string content;
+    if (!read_file(path, content))
+        return 1;
+
+    std::vector<Chunk_t> chunks;
+    uint32_t tx_lines = 0;
+    uint32_t malformed = 0;
+    if (binary)
+        load_binary(content, chunks);
+    else
+        load_log(content, chunks, tx_lines, malformed);
+
+    if (bench > 0)
+    {
+        trace_enabled = false;
+        size_t bytes = 0;
+        for (const Chunk_t &chunk : chunks)
+            bytes += chunk.data.size();
+
+        uint64_t frames = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < bench; i++)
+        {
+            Replay replay(direct);
+            replay.run(chunks);
+            frames += replay.frames();
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        /* --direct bypasses link statistics, every replayed chunk is a frame then */
+        if (direct)
+            frames = (uint64_t) chunks.size() * bench;
+        printf("%-48s %14.2f %s\n", "replay", frames / elapsed / 1e6, "M frames/s");
+        printf("%-48s %14.2f %s\n", "replay", bytes * bench / elapsed / 1e6, "MB/s");
+        return 0;
+    }
+
+    Replay replay(direct);
+    emit("input chunks=%u tx_lines=%u malformed_lines=%u", (unsigned) chunks.size(), (unsigned) tx_lines, (unsigned) malformed);
+    replay.run(chunks);
+    replay.summary();
+
+    if (check == nullptr)
+    {
+        fputs(trace.c_str(), stdout);
+        return 0;
+    }
+
+    std::string expected;
+    if (!read_file(check, expected))
+        return 1;
+    if (expected == trace)
+    {
+        printf("trace matches %s\n", check);
+        return 0;
+    }
+    /* first differing line */
+    size_t line = 1;
+    size_t pos = 0;
+    while (pos < trace.size() && pos < expected.size() && trace[pos] == expected[pos])
+    {
+        if (trace[pos] == '\n')
+            line++;
+        pos++;
+    }
+    size_t start = trace.rfind('\n', pos == 0 ? 0 : pos - 1);
+    start = (start == std::string::npos || pos == 0) ? 0 : start + 1;
+    size_t start_expected = start;
+    printf("trace differs from %s at line %u\n  expected: %s\n  actual:   %s\n", check, (unsigned) line,
+           expected.substr(start_expected, expected.find('\n', start_expected) - start_expected).c_str(),
+           trace.substr(start, trace.find('\n', start) - start).c_str());
+    return 1;
+}
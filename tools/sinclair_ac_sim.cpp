@@ -0,0 +1,200 @@
+// Simulated indoor unit on a pseudo terminal - point a host build of the controller (or any serial tool) at the printed path
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "unit_simulator.h"
+
+using namespace esphome::sinclair_ac;
+using namespace esphome::sinclair_ac::CNT;
+
+static volatile sig_atomic_t running = 1;
+
+static void stop(int)
+{
+    running = 0;
+}
+
+static uint32_t monotonic_ms()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --link PATH        symlink to the pty, e.g. /tmp/ttyAC\n"
+            "  --response MS      delay of the report answering a frame (default %u)\n"
+            "  --period MS        unsolicited report period, 0 - off (default %u)\n"
+            "  --latency MS       delay until applied settings show in reports (default %u)\n"
+            "  --noise P          bit flip probability per byte (default 0)\n"
+            "  --drop P           byte loss probability (default 0)\n"
+            "  --lenient          apply SET frames outside of an update started by 0xAF\n"
+            "  --seed N           seed of noise and drops (default %u)\n"
+            "  --duration S       exit after S seconds, 0 - run until interrupted (default 0)\n",
+            name, (unsigned) SIM_CONFIG_DEFAULT.response_delay, (unsigned) SIM_CONFIG_DEFAULT.report_period,
+            (unsigned) SIM_CONFIG_DEFAULT.apply_latency, (unsigned) SIM_CONFIG_DEFAULT.seed);
+}
+
+static void print_state(uint32_t time, const UnitReport_t &state)
+{
+    printf("%8u applied: power=%u mode=%u target=%u fan=%s vswing=%s hswing=%s display=%s unit=%s plasma=%u sleep=%u xfan=%u save=%u\n",
+           (unsigned) time, state.power, state.mode, state.target_temperature,
+           fan_modes::NAMES[state.settings.fan_mode],
+           vertical_swing_options::NAMES[state.settings.vertical_swing],
+           horizontal_swing_options::NAMES[state.settings.horizontal_swing],
+           display_options::NAMES[state.settings.display],
+           display_unit_options::NAMES[state.settings.display_unit],
+           state.settings.plasma, state.settings.sleep, state.settings.xfan, state.settings.save);
+    fflush(stdout);
+}
+
+static void print_stats(uint32_t time, const SimStats_t &stats)
+{
+    printf("%8u stats: frames_in=%u frames_bad=%u updates=%u applied=%u ignored=%u reports=%u corrupted=%u dropped=%u\n",
+           (unsigned) time, (unsigned) stats.frames_in, (unsigned) stats.frames_bad, (unsigned) stats.updates,
+           (unsigned) stats.applied, (unsigned) stats.ignored, (unsigned) stats.reports,
+           (unsigned) stats.bytes_corrupted, (unsigned) stats.bytes_dropped);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    SimConfig_t config = SIM_CONFIG_DEFAULT;
+    const char *link = nullptr;
+    uint32_t duration = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--lenient") == 0)
+        {
+            config.strict_update = false;
+            continue;
+        }
+        if (value == nullptr)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+        if (strcmp(arg, "--link") == 0)
+            link = value;
+        else if (strcmp(arg, "--response") == 0)
+            config.response_delay = strtoul(value, nullptr, 10);
+        else if (strcmp(arg, "--period") == 0)
+            config.report_period = strtoul(value, nullptr, 10);
+        else if (strcmp(arg, "--latency") == 0)
+            config.apply_latency = strtoul(value, nullptr, 10);
+        else if (strcmp(arg, "--noise") == 0)
+            config.noise_rate = strtof(value, nullptr);
+        else if (strcmp(arg, "--drop") == 0)
+            config.drop_rate = strtof(value, nullptr);
+        else if (strcmp(arg, "--seed") == 0)
+            config.seed = strtoul(value, nullptr, 10);
+        else if (strcmp(arg, "--duration") == 0)
+            duration = strtoul(value, nullptr, 10) * 1000;
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        perror("posix_openpt");
+        return 1;
+    }
+    const char *slave_path = ptsname(master);
+
+    /* raw bytes both ways - no echo, no line discipline; the slave stays open, so master does not see EIO
+       while nobody is connected */
+    int slave = open(slave_path, O_RDWR | O_NOCTTY);
+    termios tio;
+    if (slave < 0 || tcgetattr(slave, &tio) != 0)
+    {
+        perror(slave_path);
+        return 1;
+    }
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, B4800);
+    tio.c_cflag |= PARENB;
+    tcsetattr(slave, TCSANOW, &tio);
+
+    if (link != nullptr)
+    {
+        unlink(link);
+        if (symlink(slave_path, link) != 0)
+        {
+            perror(link);
+            return 1;
+        }
+    }
+    printf("unit simulator on %s\n", link != nullptr ? link : slave_path);
+    fflush(stdout);
+
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+
+    UnitSimulator unit(config);
+    unit.set_apply_callback(print_state);
+
+    uint32_t start = monotonic_ms();
+    uint32_t stats_printed = 0;
+    while (running)
+    {
+        /* wake up at least every ms, so the reports leave paced at 4800 baud */
+        pollfd pfd = {master, POLLIN, 0};
+        poll(&pfd, 1, 1);
+        uint32_t now = monotonic_ms() - start;
+
+        uint8_t buf[256];
+        if (pfd.revents & POLLIN)
+        {
+            ssize_t len = read(master, buf, sizeof(buf));
+            if (len > 0)
+            {
+                unit.write(buf, len, now);
+            }
+        }
+
+        size_t len = unit.read(buf, sizeof(buf), now);
+        if (len > 0 && write(master, buf, len) != (ssize_t) len)
+        {
+            perror("write");
+            break;
+        }
+
+        if (now - stats_printed >= 10000)
+        {
+            stats_printed = now;
+            print_stats(now, unit.stats());
+        }
+        if (duration > 0 && now >= duration)
+        {
+            break;
+        }
+    }
+
+    print_stats(monotonic_ms() - start, unit.stats());
+    if (link != nullptr)
+    {
+        unlink(link);
+    }
+    close(slave);
+    close(master);
+    return 0;
+}
@@ -0,0 +1,244 @@
+// Simulated indoor unit speaking the 0x7E7E protocol - host only, see README.md (HOST BUILD)
+#include "unit_simulator.h"
+
+namespace esphome {
+namespace sinclair_ac {
+namespace CNT {
+
+static const uint64_t READ_TIMEOUT_US = 20000;  /* same as READ_TIMEOUT of the component */
+
+static bool check_set_header(void *, uint8_t len, uint8_t cmd)
+{
+    /* other commands of the controller are recieved, but not processed */
+    return cmd != protocol::CMD_OUT_PARAMS_SET || len == protocol::SET_PACKET_LEN + 2;
+}
+
+UnitSimulator::UnitSimulator(const SimConfig_t &config) : config_(config), rng_(config.seed)
+{
+    this->state_ = {};
+    this->state_.power = false;
+    this->state_.mode = protocol::REPORT_MODE_COOL;
+    this->state_.target_temperature = 24;
+    this->state_.current_temperature = 25.5f;
+    this->state_.display_power = true;
+    this->state_.settings.display = display_options::AUTO;
+    this->state_.settings.display_mode = display_options::AUTO;
+
+    this->report_.init(protocol::CMD_IN_UNIT_REPORT);
+    this->next_report_ = (uint64_t) config.report_period * 1000;
+}
+
+void UnitSimulator::write(const uint8_t *data, size_t len, uint32_t now)
+{
+    this->advance(now);
+    this->send(this->to_unit_, data, len, (uint64_t) now * 1000);
+}
+
+size_t UnitSimulator::read(uint8_t *data, size_t max, uint32_t now)
+{
+    this->advance(now);
+
+    uint64_t now_us = (uint64_t) now * 1000;
+    size_t cnt = 0;
+    while (cnt < max && !this->to_controller_.bytes.empty() && this->to_controller_.bytes.front().time <= now_us)
+    {
+        data[cnt++] = this->to_controller_.bytes.front().data;
+        this->to_controller_.bytes.pop_front();
+    }
+    return cnt;
+}
+
+void UnitSimulator::advance(uint32_t now)
+{
+    uint64_t now_us = (uint64_t) now * 1000;
+
+    /* frames of the controller are handled once their last byte arrived */
+    while (!this->to_unit_.bytes.empty() && this->to_unit_.bytes.front().time <= now_us)
+    {
+        LineByte_t byte = this->to_unit_.bytes.front();
+        this->to_unit_.bytes.pop_front();
+        this->recieve(byte);
+    }
+    if (this->process_.state == STATE_RECIEVE && now_us - this->last_in_byte_ > READ_TIMEOUT_US)
+    {
+        serial_timeout(this->process_);
+        this->stats_.frames_bad++;
+    }
+
+    if (this->response_pending_ && this->response_time_ <= now_us)
+    {
+        this->response_pending_ = false;
+        this->report_due(this->response_time_);
+    }
+    while (this->config_.report_period > 0 && this->next_report_ <= now_us)
+    {
+        this->report_due(this->next_report_);
+        this->next_report_ += (uint64_t) this->config_.report_period * 1000;
+    }
+
+    /* unit does not queue reports - the next one is built once the line is free and shows settings applied by then,
+       reports falling due meanwhile are merged into it */
+    if (this->report_pending_ && this->to_controller_.busy_until <= now_us)
+    {
+        this->report_pending_ = false;
+        this->send_report(std::max(this->report_time_, this->to_controller_.busy_until));
+    }
+
+    this->apply_due(now_us);
+}
+
+/*
+ * Puts bytes on the wire after the ones already being sent, noise and drops are decided right away
+ */
+void UnitSimulator::send(Line_t &line, const uint8_t *data, size_t len, uint64_t now)
+{
+    uint64_t time = std::max(now, line.busy_until);
+    for (size_t i = 0; i < len; i++)
+    {
+        /* lost byte still takes its airtime */
+        time += protocol::UART_BYTE_TIME_US;
+        if (this->config_.drop_rate > 0 && this->chance_(this->rng_) < this->config_.drop_rate)
+        {
+            this->stats_.bytes_dropped++;
+            continue;
+        }
+        uint8_t byte = data[i];
+        if (this->config_.noise_rate > 0 && this->chance_(this->rng_) < this->config_.noise_rate)
+        {
+            byte ^= 1 << (this->rng_() % 8);
+            this->stats_.bytes_corrupted++;
+        }
+        line.bytes.push_back({time, byte});
+    }
+    line.busy_until = time;
+}
+
+void UnitSimulator::recieve(const LineByte_t &byte)
+{
+    if (this->process_.state == STATE_RECIEVE && byte.time - this->last_in_byte_ > READ_TIMEOUT_US)
+    {
+        serial_timeout(this->process_);
+        this->stats_.frames_bad++;
+    }
+    this->last_in_byte_ = byte.time;
+
+    FrameEvent event;
+    serial_parse(this->process_, &byte.data, 1, &check_set_header, nullptr, event);
+    switch (event)
+    {
+        case FrameEvent::NONE:
+        case FrameEvent::LENGTH_ERROR:
+            break;
+        case FrameEvent::HEADER_ERROR:
+        case FrameEvent::CHECKSUM_ERROR:
+            this->stats_.frames_bad++;
+            break;
+        case FrameEvent::FRAME:
+        {
+            FrameView frame = {this->process_.pending->data, this->process_.pending->data_cnt};
+            this->handle_frame(frame, byte.time);
+            this->process_.pending = nullptr;
+            break;
+        }
+    }
+}
+
+void UnitSimulator::handle_frame(const FrameView &frame, uint64_t time)
+{
+    this->stats_.frames_in++;
+
+    /* every frame of the controller is answered, an update being applied does not delay the answer */
+    if (!this->response_pending_)
+    {
+        this->response_pending_ = true;
+        this->response_time_ = time + (uint64_t) this->config_.response_delay * 1000;
+    }
+
+    if (frame[3] != protocol::CMD_OUT_PARAMS_SET)
+    {
+        return;
+    }
+
+    FrameView payload = {frame.data + 4, (uint8_t) (frame.len - 5)};
+    bool start, apply;
+    decode_set_update(payload, start, apply);
+
+    if (!apply)
+    {
+        this->update_open_ = false;
+        return;
+    }
+    if (start)
+    {
+        this->update_open_ = true;
+        this->stats_.updates++;
+    }
+    else if (!this->update_open_ && this->config_.strict_update)
+    {
+        this->stats_.ignored++;
+        return;
+    }
+
+    UnitReport_t set;
+    if (!decode_unit_report(payload, set))
+    {
+        return;
+    }
+    this->stats_.applied++;
+
+    /* current temperature is the unit's own, the controller only sends zeroes there */
+    set.current_temperature = this->state_.current_temperature;
+    this->applied_ = set;
+    this->apply_pending_ = true;
+    this->apply_time_ = time + (uint64_t) this->config_.apply_latency * 1000;
+}
+
+void UnitSimulator::apply_due(uint64_t time)
+{
+    if (!this->apply_pending_ || this->apply_time_ > time)
+    {
+        return;
+    }
+    this->apply_pending_ = false;
+
+    float current_temperature = this->state_.current_temperature;
+    this->state_ = this->applied_;
+    this->state_.current_temperature = current_temperature;
+    this->state_.unknown = 0;
+    if (this->apply_callback_)
+    {
+        this->apply_callback_(this->apply_time_ / 1000, this->state_);
+    }
+}
+
+void UnitSimulator::report_due(uint64_t time)
+{
+    if (!this->report_pending_)
+    {
+        this->report_pending_ = true;
+        this->report_time_ = time;
+    }
+}
+
+void UnitSimulator::send_report(uint64_t time)
+{
+    this->apply_due(time);
+
+    const UnitReport_t &state = this->state_;
+    this->report_.encode_mode(state.mode, state.power);
+    this->report_.encode_target_temperature(state.target_temperature);
+    this->report_.encode_fan_mode(state.settings.fan_mode);
+    this->report_.encode_vertical_swing(state.settings.vertical_swing);
+    this->report_.encode_horizontal_swing(state.settings.horizontal_swing);
+    this->report_.encode_display(state.display_power ? (uint8_t) state.settings.display : (uint8_t) display_options::OFF,
+                                 state.settings.display_mode);
+    this->report_.encode_flags(state.settings);
+    this->report_.encode_current_temperature(state.current_temperature);
+
+    this->stats_.reports++;
+    this->send(this->to_controller_, this->report_.data(), this->report_.size(), time);
+}
+
+}  // namespace CNT
+}  // namespace sinclair_ac
+}  // namespace esphome
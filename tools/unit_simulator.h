@@ -0,0 +1,113 @@
+// Simulated indoor unit speaking the 0x7E7E protocol - host only, see README.md (HOST BUILD)
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <random>
+
+#include "esppac_core.h"
+
+namespace esphome {
+namespace sinclair_ac {
+namespace CNT {
+
+typedef struct {
+        uint32_t response_delay;  /* ms from a valid frame of the controller to the report answering it */
+        uint32_t report_period;   /* ms between unsolicited reports, 0 - unit only answers */
+        uint32_t apply_latency;   /* ms from an applied SET frame until reports show the new settings */
+        float noise_rate;         /* probability of a flipped bit per byte on the wire, both directions */
+        float drop_rate;          /* probability of a byte lost on the wire, both directions */
+        bool strict_update;       /* SET frames are applied only within an update started by 0xAF */
+        uint32_t seed;            /* line noise is deterministic for given seed */
+} SimConfig_t;
+
+static const SimConfig_t SIM_CONFIG_DEFAULT = {20, 0, 0, 0.0f, 0.0f, true, 1};
+
+typedef struct {
+        uint32_t frames_in;        /* valid frames from the controller */
+        uint32_t frames_bad;       /* frames from the controller dropped by framing - checksum, length or timeout */
+        uint32_t updates;          /* updates started by 0xAF */
+        uint32_t applied;          /* SET frames applied */
+        uint32_t ignored;          /* SET frames asking to apply outside of an update, strict_update only */
+        uint32_t reports;          /* reports put on the wire */
+        uint32_t bytes_corrupted;  /* both directions */
+        uint32_t bytes_dropped;
+} SimStats_t;
+
+/* Unit answering frames of the controller with unit reports, UART airtime at 4800 baud 8E1 is simulated
+   in both directions. Update semantics the component relies on:
+   - SET with 0xAF and cleared NOCHANGE flag starts an update and is applied
+   - SET without 0xAF and cleared NOCHANGE flag is applied while the update is open
+   - SET with NOCHANGE flag set (keep-alive) closes the update, its content is ignored */
+class UnitSimulator {
+    public:
+        explicit UnitSimulator(const SimConfig_t &config = SIM_CONFIG_DEFAULT);
+
+        /* bytes written by the controller at now (ms), they reach the unit after their airtime */
+        void write(const uint8_t *data, size_t len, uint32_t now);
+        /* bytes of the unit that reached the controller by now, returns number of bytes stored to data */
+        size_t read(uint8_t *data, size_t max, uint32_t now);
+        /* runs the unit until now - write() and read() do this as well */
+        void advance(uint32_t now);
+
+        /* state the unit reports, may be changed to simulate the remote control */
+        UnitReport_t &state() { return this->state_; }
+        bool update_open() const { return this->update_open_; }
+        const SimStats_t &stats() const { return this->stats_; }
+
+        /* called when settings of a SET frame take effect, with time in ms */
+        void set_apply_callback(std::function<void(uint32_t, const UnitReport_t &)> &&callback)
+        {
+            this->apply_callback_ = std::move(callback);
+        }
+
+    protected:
+        typedef struct {
+                uint64_t time;  /* us at which the last bit of the byte is on the other side */
+                uint8_t data;
+        } LineByte_t;
+
+        /* one direction of the wire */
+        typedef struct {
+                std::deque<LineByte_t> bytes;
+                uint64_t busy_until;  /* us at which the last queued byte is sent */
+        } Line_t;
+
+        SimConfig_t config_;
+        SimStats_t stats_ = {};
+        std::mt19937 rng_;
+        std::uniform_real_distribution<float> chance_{0.0f, 1.0f};
+
+        Line_t to_unit_ = {};
+        Line_t to_controller_ = {};
+
+        SerialProcess_t process_ = {};
+        uint64_t last_in_byte_;          /* us, for the partial frame timeout */
+
+        UnitReport_t state_;
+        bool update_open_ = false;
+        bool apply_pending_ = false;     /* settings of an applied SET waiting for apply_latency */
+        uint64_t apply_time_;
+        UnitReport_t applied_;
+
+        bool response_pending_ = false;
+        uint64_t response_time_;
+        uint64_t next_report_;           /* us of the next unsolicited report */
+        bool report_pending_ = false;    /* report waiting for the line to become free */
+        uint64_t report_time_;
+
+        SetFrame report_;
+        std::function<void(uint32_t, const UnitReport_t &)> apply_callback_;
+
+        void send(Line_t &line, const uint8_t *data, size_t len, uint64_t now);
+        void recieve(const LineByte_t &byte);
+        void handle_frame(const FrameView &frame, uint64_t time);
+        void apply_due(uint64_t time);
+        void report_due(uint64_t time);
+        void send_report(uint64_t time);
+};
+
+}  // namespace CNT
+}  // namespace sinclair_ac
+}  // namespace esphome